@@ -0,0 +1,191 @@
+// Load generator for solver-server.
+//
+// Opens several connections, each keeping a window of requests in flight so
+// the server sees concurrent work it can batch. Each request replays a random
+// partial game: a random target word and up to four random guesses colored
+// against it. Prints throughput and client-side round trip latencies.
+//
+// Before the load run it checks that a truncated request is rejected with
+// STATUS_BAD_REQUEST and request id 0, since the frame ends before the id.
+//
+// usage: solver-client [connections] [requests per connection] [in flight per connection]
+//                      [wordlist] [socket path]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "solver-protocol.h"
+
+using namespace std;
+using namespace solver;
+
+typedef chrono::steady_clock Clock;
+
+struct ClientResult {
+    vector<uint64_t> latencies;
+    uint64_t errors;
+};
+
+int connectTo(const string& socketPath) {
+    sockaddr_un address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+Request randomRequest(const vector<string>& words, mt19937& rng, uint32_t requestId) {
+    uniform_int_distribution<size_t> pickWord(0, words.size() - 1);
+    uniform_int_distribution<int> pickRounds(0, 4);
+
+    Request request;
+    request.type = rng() % 2 == 0 ? REQUEST_NEXT_GUESS : REQUEST_COUNT;
+    request.requestId = requestId;
+
+    const string& target = words[pickWord(rng)];
+    int rounds = pickRounds(rng);
+    for (int i = 0; i < rounds; ++i) {
+        Round round;
+        memcpy(round.guess, words[pickWord(rng)].data(), WORD_LENGTH);
+        scoreGuess(round.guess, target, round.pattern);
+        request.rounds.push_back(round);
+    }
+    return request;
+}
+
+// sends a frame too short to hold a request id; returns false unless the
+// server answers STATUS_BAD_REQUEST for request 0
+bool checkTruncatedFrame(const string& socketPath) {
+    int fd = connectTo(socketPath);
+    if (fd < 0) return false;
+
+    string payload;
+    Response response;
+    bool ok = writeFrame(fd, string(1, (char)REQUEST_COUNT))
+        && readFrame(fd, payload) && decodeResponse(payload, response)
+        && response.status == STATUS_BAD_REQUEST && response.requestId == 0;
+    close(fd);
+    return ok;
+}
+
+void runConnection(const string& socketPath, const vector<string>& words, int requests,
+                   int window, unsigned int seed, ClientResult& result) {
+    result.errors = 0;
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        result.errors = requests;
+        return;
+    }
+
+    mt19937 rng(seed);
+    unordered_map<uint32_t, Clock::time_point> inFlight;
+    uint32_t nextId = 0;
+    int completed = 0;
+    string payload;
+
+    while (completed < requests) {
+        // top up the window
+        while ((int)inFlight.size() < window && (int)nextId < requests) {
+            Request request = randomRequest(words, rng, nextId);
+            inFlight[nextId] = Clock::now();
+            nextId++;
+            if (!writeFrame(fd, encodeRequest(request))) {
+                result.errors += requests - completed;
+                close(fd);
+                return;
+            }
+        }
+
+        Response response;
+        if (!readFrame(fd, payload) || !decodeResponse(payload, response)) {
+            result.errors += requests - completed;
+            break;
+        }
+        auto sent = inFlight.find(response.requestId);
+        if (sent == inFlight.end()) {
+            result.errors++;
+        } else {
+            // a rejected request is answered too, and frees its window slot
+            if (response.status == STATUS_BAD_REQUEST) result.errors++;
+            else result.latencies.push_back(chrono::duration_cast<chrono::microseconds>(Clock::now() - sent->second).count());
+            inFlight.erase(sent);
+        }
+        completed++;
+    }
+    close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    int connections = argc > 1 ? atoi(argv[1]) : 8;
+    int requests = argc > 2 ? atoi(argv[2]) : 2000;
+    int window = argc > 3 ? atoi(argv[3]) : 4;
+    string wordlist = argc > 4 ? argv[4] : "../wordlist.txt";
+    string socketPath = argc > 5 ? argv[5] : DEFAULT_SOCKET_PATH;
+
+    vector<string> words;
+    ifstream file(wordlist);
+    string word;
+    while (file >> word) {
+        if (word.length() == WORD_LENGTH) words.push_back(word);
+    }
+    if (words.empty()) {
+        cerr << "no words loaded from " << wordlist << endl;
+        return 1;
+    }
+
+    if (!checkTruncatedFrame(socketPath)) {
+        cerr << "truncated request was not rejected with request id 0, is solver-server running?" << endl;
+        return 1;
+    }
+    cout << "truncated request rejected with request id 0" << endl;
+
+    vector<ClientResult> results(connections);
+    vector<thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < connections; ++i) {
+        threads.emplace_back(runConnection, cref(socketPath), cref(words), requests, window,
+                             1234u + i, ref(results[i]));
+    }
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    vector<uint64_t> latencies;
+    uint64_t errors = 0;
+    for (const ClientResult& r : results) {
+        latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+        errors += r.errors;
+    }
+    if (latencies.empty()) {
+        cerr << "no successful requests (" << errors << " errors), is solver-server running?" << endl;
+        return 1;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](double p) {
+        size_t index = min(latencies.size() - 1, (size_t)(p / 100.0 * latencies.size()));
+        return latencies[index];
+    };
+
+    cout << connections << " connections x " << requests << " requests, window " << window << endl;
+    cout << "completed " << latencies.size() << " requests in " << seconds << "s ("
+         << (uint64_t)(latencies.size() / seconds) << " req/s), " << errors << " errors" << endl;
+    cout << "latency p50 " << percentile(50) << "us, p90 " << percentile(90) << "us, p99 "
+         << percentile(99) << "us, max " << latencies.back() << "us" << endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#ifndef ASSIGNMENT_4_SOLVER_PROTOCOL_H
+#define ASSIGNMENT_4_SOLVER_PROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <unistd.h>
+
+// Wire protocol shared by solver-server and solver-client.
+//
+// Every message is a frame: a uint32 payload length followed by the payload.
+// Integers are sent in host byte order, the socket is local only.
+//
+// Request payload:
+//   uint8  type          (REQUEST_NEXT_GUESS or REQUEST_COUNT)
+//   uint32 requestId     (echoed back in the response)
+//   uint8  numRounds
+//   numRounds x { char guess[5]; char pattern[5]; }   pattern uses g / y / b
+//
+// Response payload:
+//   uint32 requestId
+//   uint8  status
+//   uint32 candidates    (number of words matching every round)
+//   char   guess[5]      (first matching word, only for REQUEST_NEXT_GUESS)
+
+namespace solver {
+
+const char DEFAULT_SOCKET_PATH[] = "/tmp/wordle-solver.sock";
+
+const unsigned int WORD_LENGTH = 5;
+const unsigned int MAX_ROUNDS = 16;
+const uint32_t MAX_FRAME_SIZE = 1 + 4 + 1 + MAX_ROUNDS * 2 * WORD_LENGTH;
+
+enum RequestType : uint8_t {
+    REQUEST_NEXT_GUESS = 1,
+    REQUEST_COUNT = 2
+};
+
+enum ResponseStatus : uint8_t {
+    STATUS_OK = 0,
+    STATUS_BAD_REQUEST = 1,
+    STATUS_NO_CANDIDATES = 2
+};
+
+struct Round {
+    char guess[WORD_LENGTH];
+    char pattern[WORD_LENGTH];
+};
+
+struct Request {
+    uint8_t type;
+    uint32_t requestId;
+    std::vector<Round> rounds;
+};
+
+struct Response {
+    uint32_t requestId;
+    uint8_t status;
+    uint32_t candidates;
+    char guess[WORD_LENGTH];
+};
+
+const uint32_t RESPONSE_SIZE = 4 + 1 + 4 + WORD_LENGTH;
+
+// reads exactly len bytes, returns false on EOF or error
+inline bool readFully(int fd, void* buffer, size_t len) {
+    char* out = static_cast<char*>(buffer);
+    while (len > 0) {
+        ssize_t n = ::read(fd, out, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        out += n;
+        len -= n;
+    }
+    return true;
+}
+
+// writes exactly len bytes, returns false on error
+inline bool writeFully(int fd, const void* buffer, size_t len) {
+    const char* in = static_cast<const char*>(buffer);
+    while (len > 0) {
+        ssize_t n = ::write(fd, in, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        in += n;
+        len -= n;
+    }
+    return true;
+}
+
+// reads one frame into payload, returns false on EOF, error or oversized frame
+inline bool readFrame(int fd, std::string& payload) {
+    uint32_t len;
+    if (!readFully(fd, &len, sizeof(len))) return false;
+    if (len > MAX_FRAME_SIZE) return false;
+    payload.resize(len);
+    return len == 0 || readFully(fd, &payload[0], len);
+}
+
+inline bool writeFrame(int fd, const std::string& payload) {
+    std::string frame(sizeof(uint32_t), '\0');
+    uint32_t len = payload.size();
+    std::memcpy(&frame[0], &len, sizeof(len));
+    frame += payload;
+    return writeFully(fd, frame.data(), frame.size());
+}
+
+inline std::string encodeRequest(const Request& request) {
+    std::string out;
+    out.push_back(static_cast<char>(request.type));
+    out.append(reinterpret_cast<const char*>(&request.requestId), sizeof(request.requestId));
+    out.push_back(static_cast<char>(request.rounds.size()));
+    for (const Round& round : request.rounds) {
+        out.append(round.guess, WORD_LENGTH);
+        out.append(round.pattern, WORD_LENGTH);
+    }
+    return out;
+}
+
+// returns false if the payload is malformed
+inline bool decodeRequest(const std::string& payload, Request& request) {
+    if (payload.size() < 6) return false;
+    request.type = static_cast<uint8_t>(payload[0]);
+    std::memcpy(&request.requestId, payload.data() + 1, sizeof(request.requestId));
+    unsigned int numRounds = static_cast<uint8_t>(payload[5]);
+    if (numRounds > MAX_ROUNDS || payload.size() != 6 + numRounds * 2 * WORD_LENGTH) return false;
+
+    request.rounds.resize(numRounds);
+    const char* cursor = payload.data() + 6;
+    for (unsigned int i = 0; i < numRounds; ++i) {
+        std::memcpy(request.rounds[i].guess, cursor, WORD_LENGTH);
+        std::memcpy(request.rounds[i].pattern, cursor + WORD_LENGTH, WORD_LENGTH);
+        cursor += 2 * WORD_LENGTH;
+    }
+    return true;
+}
+
+inline std::string encodeResponse(const Response& response) {
+    std::string out;
+    out.append(reinterpret_cast<const char*>(&response.requestId), sizeof(response.requestId));
+    out.push_back(static_cast<char>(response.status));
+    out.append(reinterpret_cast<const char*>(&response.candidates), sizeof(response.candidates));
+    out.append(response.guess, WORD_LENGTH);
+    return out;
+}
+
+inline bool decodeResponse(const std::string& payload, Response& response) {
+    if (payload.size() != RESPONSE_SIZE) return false;
+    std::memcpy(&response.requestId, payload.data(), sizeof(response.requestId));
+    response.status = static_cast<uint8_t>(payload[4]);
+    std::memcpy(&response.candidates, payload.data() + 5, sizeof(response.candidates));
+    std::memcpy(response.guess, payload.data() + 9, WORD_LENGTH);
+    return true;
+}
+
+// colors a guess against the target the same way TrieGamePlay does in main.cpp
+inline void scoreGuess(const char* guess, const std::string& target, char* pattern) {
+    for (unsigned int i = 0; i < WORD_LENGTH; ++i) {
+        if (guess[i] == target[i]) pattern[i] = 'g';
+        else if (target.find(guess[i]) != std::string::npos) pattern[i] = 'y';
+        else pattern[i] = 'b';
+    }
+}
+
+}  // namespace solver
+
+#endif
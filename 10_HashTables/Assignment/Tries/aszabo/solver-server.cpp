@@ -0,0 +1,420 @@
+// Standalone Wordle solver server.
+//
+// Loads the dictionary into a Trie once, flattens it into a sorted word array
+// and answers requests from local clients over a Unix domain socket (see
+// solver-protocol.h for the wire format). Requests that arrive while a filter
+// pass is running are queued and answered together by the next pass, so a
+// burst of N concurrent requests costs one walk over the dictionary instead
+// of N. Per-request latency histograms are printed on shutdown (Ctrl-C).
+//
+// usage: solver-server [wordlist] [socket path]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Trie.h"
+#include "solver-protocol.h"
+
+using namespace std;
+using namespace solver;
+
+typedef chrono::steady_clock Clock;
+
+// upper bound on how many queued requests share a single filter pass
+const size_t MAX_BATCH = 512;
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onSignal(int) {
+    stopRequested = 1;
+}
+
+// log2-bucketed latency histogram, bucket i counts latencies in [2^(i-1), 2^i) microseconds
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 32;
+
+    LatencyHistogram() : count_(0), totalMicros_(0), maxMicros_(0) {
+        for (int i = 0; i < BUCKETS; ++i) buckets_[i] = 0;
+    }
+
+    void record(uint64_t micros) {
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && (uint64_t(1) << bucket) <= micros) bucket++;
+        buckets_[bucket]++;
+        count_++;
+        totalMicros_ += micros;
+        maxMicros_ = max(maxMicros_, micros);
+    }
+
+    // upper edge of the bucket containing the given percentile
+    uint64_t percentile(double p) const {
+        uint64_t target = (uint64_t)(p / 100.0 * count_);
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen > target) return uint64_t(1) << i;
+        }
+        return maxMicros_;
+    }
+
+    void print(const string& name) const {
+        cout << name << ": " << count_ << " requests";
+        if (count_ == 0) {
+            cout << endl;
+            return;
+        }
+        cout << ", mean " << totalMicros_ / count_ << "us"
+             << ", p50 <" << percentile(50) << "us"
+             << ", p99 <" << percentile(99) << "us"
+             << ", max " << maxMicros_ << "us" << endl;
+        for (int i = 0; i < BUCKETS; ++i) {
+            if (buckets_[i] == 0) continue;
+            uint64_t low = i == 0 ? 0 : uint64_t(1) << (i - 1);
+            cout << "  [" << low << ", " << (uint64_t(1) << i) << ") us: " << buckets_[i] << endl;
+        }
+    }
+
+private:
+    uint64_t buckets_[BUCKETS];
+    uint64_t count_;
+    uint64_t totalMicros_;
+    uint64_t maxMicros_;
+};
+
+// a word flattened out of the trie, with its letters pre-decoded to 0..25
+struct DictionaryWord {
+    string word;
+    unsigned char letters[WORD_LENGTH];
+    uint32_t letterMask;
+};
+
+// all rounds of a request folded into bitmasks: allowed[i] holds the letters
+// that may appear at position i, required holds letters that must appear somewhere.
+// This keeps the same g / y / b semantics as filterWordList in main.cpp.
+struct Constraint {
+    uint32_t allowed[WORD_LENGTH];
+    uint32_t required;
+
+    bool matches(const DictionaryWord& w) const {
+        if ((w.letterMask & required) != required) return false;
+        for (unsigned int i = 0; i < WORD_LENGTH; ++i) {
+            if (!(allowed[i] & (1u << w.letters[i]))) return false;
+        }
+        return true;
+    }
+};
+
+// returns false if a guess or pattern holds characters outside a-z / gyb
+bool compileConstraint(const vector<Round>& rounds, Constraint& c) {
+    const uint32_t ALL_LETTERS = (1u << 26) - 1;
+    for (unsigned int i = 0; i < WORD_LENGTH; ++i) c.allowed[i] = ALL_LETTERS;
+    c.required = 0;
+
+    for (const Round& round : rounds) {
+        for (unsigned int i = 0; i < WORD_LENGTH; ++i) {
+            char letter = round.guess[i];
+            if (letter < 'a' || letter > 'z') return false;
+            uint32_t bit = 1u << (letter - 'a');
+
+            if (round.pattern[i] == 'g') {
+                c.allowed[i] &= bit;
+            } else if (round.pattern[i] == 'y') {
+                c.allowed[i] &= ~bit;
+                c.required |= bit;
+            } else if (round.pattern[i] == 'b') {
+                for (unsigned int j = 0; j < WORD_LENGTH; ++j) c.allowed[j] &= ~bit;
+            } else {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// one client socket, shared by its reader thread and the batcher
+struct Connection {
+    int fd;
+    mutex writeLock;
+
+    explicit Connection(int socketFd) : fd(socketFd) {}
+    ~Connection() { close(fd); }
+
+    void send(const Response& response) {
+        lock_guard<mutex> guard(writeLock);
+        writeFrame(fd, encodeResponse(response));
+    }
+};
+
+struct PendingRequest {
+    shared_ptr<Connection> connection;
+    Request request;
+    Constraint constraint;
+    Clock::time_point received;
+};
+
+class SolverServer {
+public:
+    explicit SolverServer(vector<DictionaryWord>&& words)
+        : words_(move(words)), stopping_(false), batches_(0), batchedRequests_(0) {}
+
+    void start() {
+        batcher_ = thread(&SolverServer::batchLoop, this);
+    }
+
+    // disconnects every client and waits for all threads to finish, so
+    // nothing touches the server once this returns
+    void stop() {
+        {
+            lock_guard<mutex> guard(clientsLock_);
+            for (Client& client : clients_) shutdown(client.connection->fd, SHUT_RDWR);
+        }
+        // only the accepting thread adds clients, and it is the one stopping
+        for (Client& client : clients_) client.reader.join();
+        clients_.clear();
+
+        {
+            lock_guard<mutex> guard(queueLock_);
+            stopping_ = true;
+        }
+        queueReady_.notify_one();
+        batcher_.join();
+    }
+
+    // starts a reader thread for a newly accepted client socket
+    void addClient(int fd) {
+        lock_guard<mutex> guard(clientsLock_);
+        reapClients();
+        clients_.emplace_back();
+        Client& client = clients_.back();
+        client.connection = make_shared<Connection>(fd);
+        client.reader = thread(&SolverServer::serve, this, &client);
+    }
+
+    void printStats() {
+        lock_guard<mutex> guard(statsLock_);
+        cout << "dictionary: " << words_.size() << " words" << endl;
+        cout << "filter passes: " << batches_;
+        if (batches_ > 0) cout << ", mean batch size " << (double)batchedRequests_ / batches_;
+        cout << endl;
+        nextGuessLatency_.print("next-guess");
+        countLatency_.print("candidate-count");
+    }
+
+private:
+    // a connected client and the thread reading its requests
+    struct Client {
+        shared_ptr<Connection> connection;
+        thread reader;
+        bool finished = false;
+    };
+
+    // joins and forgets the clients that have disconnected
+    void reapClients() {
+        for (list<Client>::iterator it = clients_.begin(); it != clients_.end();) {
+            if (!it->finished) {
+                ++it;
+                continue;
+            }
+            it->reader.join();
+            it = clients_.erase(it);
+        }
+    }
+
+    // runs on the client's reader thread until it disconnects or the server stops
+    void serve(Client* client) {
+        shared_ptr<Connection> connection = client->connection;
+        string payload;
+        while (readFrame(connection->fd, payload)) {
+            PendingRequest pending = PendingRequest();
+            pending.received = Clock::now();
+            pending.connection = connection;
+
+            bool valid = decodeRequest(payload, pending.request)
+                && (pending.request.type == REQUEST_NEXT_GUESS || pending.request.type == REQUEST_COUNT)
+                && compileConstraint(pending.request.rounds, pending.constraint);
+            if (!valid) {
+                Response response = Response();
+                response.requestId = pending.request.requestId;
+                response.status = STATUS_BAD_REQUEST;
+                connection->send(response);
+                continue;
+            }
+
+            {
+                lock_guard<mutex> guard(queueLock_);
+                queue_.push_back(move(pending));
+            }
+            queueReady_.notify_one();
+        }
+
+        lock_guard<mutex> guard(clientsLock_);
+        client->finished = true;
+    }
+
+    void batchLoop() {
+        vector<PendingRequest> batch;
+        while (true) {
+            {
+                unique_lock<mutex> guard(queueLock_);
+                queueReady_.wait(guard, [this] { return stopping_ || !queue_.empty(); });
+                if (stopping_ && queue_.empty()) return;
+
+                size_t take = min(queue_.size(), MAX_BATCH);
+                batch.clear();
+                for (size_t i = 0; i < take; ++i) {
+                    batch.push_back(move(queue_.front()));
+                    queue_.pop_front();
+                }
+            }
+            runBatch(batch);
+        }
+    }
+
+    // a single walk over the dictionary answers every request in the batch
+    void runBatch(vector<PendingRequest>& batch) {
+        size_t n = batch.size();
+        vector<uint32_t> counts(n, 0);
+        vector<int> firstMatch(n, -1);
+
+        for (size_t w = 0; w < words_.size(); ++w) {
+            const DictionaryWord& word = words_[w];
+            for (size_t r = 0; r < n; ++r) {
+                if (batch[r].constraint.matches(word)) {
+                    if (firstMatch[r] < 0) firstMatch[r] = (int)w;
+                    counts[r]++;
+                }
+            }
+        }
+
+        for (size_t r = 0; r < n; ++r) {
+            PendingRequest& pending = batch[r];
+            Response response = Response();
+            response.requestId = pending.request.requestId;
+            response.candidates = counts[r];
+            response.status = counts[r] == 0 ? STATUS_NO_CANDIDATES : STATUS_OK;
+            if (pending.request.type == REQUEST_NEXT_GUESS && firstMatch[r] >= 0) {
+                memcpy(response.guess, words_[firstMatch[r]].word.data(), WORD_LENGTH);
+            }
+            pending.connection->send(response);
+
+            uint64_t micros = chrono::duration_cast<chrono::microseconds>(Clock::now() - pending.received).count();
+            lock_guard<mutex> guard(statsLock_);
+            if (pending.request.type == REQUEST_NEXT_GUESS) nextGuessLatency_.record(micros);
+            else countLatency_.record(micros);
+        }
+
+        lock_guard<mutex> guard(statsLock_);
+        batches_++;
+        batchedRequests_ += n;
+    }
+
+    const vector<DictionaryWord> words_;
+
+    mutex queueLock_;
+    condition_variable queueReady_;
+    deque<PendingRequest> queue_;
+    bool stopping_;
+    thread batcher_;
+
+    mutex clientsLock_;
+    list<Client> clients_;
+
+    mutex statsLock_;
+    uint64_t batches_;
+    uint64_t batchedRequests_;
+    LatencyHistogram nextGuessLatency_;
+    LatencyHistogram countLatency_;
+};
+
+// builds the trie once and flattens it into a sorted array for filter passes
+vector<DictionaryWord> loadDictionary(const string& filename) {
+    Trie trie;
+    ifstream file(filename);
+    string word;
+    while (file >> word)
+        trie.insert(word);
+
+    list<string> all = trie.getAllWords();
+    vector<string> sorted(all.begin(), all.end());
+    sort(sorted.begin(), sorted.end());
+
+    vector<DictionaryWord> words;
+    for (const string& w : sorted) {
+        DictionaryWord entry;
+        entry.word = w;
+        entry.letterMask = 0;
+        bool lowercase = true;
+        for (unsigned int i = 0; i < WORD_LENGTH; ++i) {
+            if (w[i] < 'a' || w[i] > 'z') lowercase = false;
+            entry.letters[i] = w[i] - 'a';
+            entry.letterMask |= 1u << entry.letters[i];
+        }
+        if (lowercase) words.push_back(entry);
+    }
+    return words;
+}
+
+int main(int argc, char* argv[]) {
+    string wordlist = argc > 1 ? argv[1] : "../wordlist.txt";
+    string socketPath = argc > 2 ? argv[2] : DEFAULT_SOCKET_PATH;
+
+    vector<DictionaryWord> words = loadDictionary(wordlist);
+    if (words.empty()) {
+        cerr << "no words loaded from " << wordlist << endl;
+        return 1;
+    }
+    cout << "loaded " << words.size() << " words from " << wordlist << endl;
+
+    sockaddr_un address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "socket path too long: " << socketPath << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listenFd, 128) < 0) {
+        perror("solver-server");
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    SolverServer server(move(words));
+    server.start();
+    cout << "listening on " << socketPath << endl;
+
+    while (!stopRequested) {
+        pollfd pfd = {listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) continue;
+        server.addClient(clientFd);
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    server.stop();
+    server.printStats();
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "bloom-filter.h"
+#include "record.h"
+using namespace std;
+
+// A HashTable keyed on idName with a blocked Bloom filter in front of it.
+// See bloom-filter.h.
+
+// millions of searches per second, and how many found something
+template <class Table>
+double timeSearches(Table& table, const vector<string>& names, int& found) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	found = 0;
+	for (const string& name : names)
+		if (table.search(name) != NULL) found++;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return names.size() / seconds / 1e6;
+}
+
+
+int main()
+{
+	BloomFilteredHashTable<string, Record> h;
+
+	h.emplace("jacob", 1000101, "jacob",  "jacob23@uw.ca");
+	h.emplace("shawn", 2001201, "shawn",  "shawn3@uw.ca");
+	h.emplace("max", 3003121, "max",  "maxmax@uw.ca");
+	h.emplace("grace", 3004578, "grace",  "grace2@uw.ca");
+
+	if ( !h.remove("jack") )
+		cout << "cannot remove when the key does not exist." << endl;
+	cout << h.rejected() << " lookup(s) answered by the filter alone" << endl;
+
+	Record* result = h.search("grace");
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	// miss-heavy workload: every lookup is for a name that is not there
+	const int n = 1000000;
+	HashTable<string, Record> plain;
+	BloomFilteredHashTable<string, Record> filtered(n, 0.01);
+	vector<string> missing;
+	for (int i = 0; i < n; i++) {
+		string name = "member" + to_string(i);
+		plain.emplace(name, i, name, name + "@uw.ca");
+		filtered.emplace(name, i, name, name + "@uw.ca");
+		missing.push_back("visitor" + to_string(i));
+	}
+
+	int found[2];
+	double plainRate = timeSearches(plain, missing, found[0]);
+	size_t rejectedBefore = filtered.rejected();
+	double filteredRate = timeSearches(filtered, missing, found[1]);
+	double falsePositives = 1.0 - (double)(filtered.rejected() - rejectedBefore) / n;
+
+	cout<< endl << n << " missing names, filter of " << filtered.filter().memoryUsage() / 1024 << " KiB with "
+	    << filtered.filter().hashes() << " hashes per key" << endl;
+	cout<< "plain table:    " << plainRate << " M searches/s (" << found[0] << " found)" << endl;
+	cout<< "filtered table: " << filteredRate << " M searches/s (" << found[1] << " found), "
+	    << falsePositives * 100 << "% false positives" << endl;
+
+	// removals leave stale bits behind until the filter is rebuilt
+	for (int i = 0; i < n / 2; i++) filtered.remove("member" + to_string(i));
+	cout<< "after removing half: " << filtered.size() << " names, filter rebuilt for "
+	    << filtered.filter().capacity() << " keys" << endl;
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#ifndef HASH_TABLES_BLOOM_FILTER_H
+#define HASH_TABLES_BLOOM_FILTER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "hash-table.h"
+
+// Blocked Bloom filter over 64-bit key hashes.
+//
+// The bit array is split into 512-bit blocks, one cache line each. The high
+// half of a key's hash picks the block and the low half picks the key's k bits
+// inside it, so an add or a query touches exactly one cache line. A "no" is
+// always right; a "maybe" is wrong about as often as the false positive rate
+// the filter was sized for (a little more, since blocks fill unevenly).
+//
+// Bits cannot be cleared, so a removed key keeps answering "maybe" until the
+// filter is cleared and refilled.
+class BlockedBloomFilter {
+public:
+    static const unsigned int BLOCK_BITS = 512;
+    static const unsigned int MAX_HASHES = 16;
+
+    // sized for expectedKeys keys at the given false positive rate
+    explicit BlockedBloomFilter(size_t expectedKeys = 1024, double falsePositiveRate = 0.01)
+        : capacity_(expectedKeys < 1 ? 1 : expectedKeys), falsePositiveRate_(falsePositiveRate) {
+        // optimal bits per key is -ln(p) / ln(2)^2, with ln(2) * bits per key hash functions
+        double bitsPerKey = -std::log(falsePositiveRate) / (std::log(2.0) * std::log(2.0));
+        hashes_ = (unsigned int)std::lround(bitsPerKey * std::log(2.0));
+        if (hashes_ < 1) hashes_ = 1;
+        if (hashes_ > MAX_HASHES) hashes_ = MAX_HASHES;
+
+        size_t blocks = (size_t)std::ceil(capacity_ * bitsPerKey / BLOCK_BITS);
+        blocks_.assign(blocks < 1 ? 1 : blocks, Block());
+    }
+
+    void add(uint64_t hash) {
+        Block& block = blocks_[blockOf(hash)];
+        uint32_t h1 = (uint32_t)hash;
+        uint32_t h2 = (h1 >> 17) | (h1 << 15) | 1;
+        for (unsigned int i = 0; i < hashes_; ++i, h1 += h2) {
+            unsigned int bit = h1 >> 23;    // 9 bits: a position in the block
+            block.words[bit / 64] |= (uint64_t)1 << (bit % 64);
+        }
+    }
+
+    // builds the key's bit pattern first and compares all 8 words at once, so
+    // a miss costs no unpredictable branch per bit
+    bool mayContain(uint64_t hash) const {
+        const Block& block = blocks_[blockOf(hash)];
+        uint64_t pattern[BLOCK_BITS / 64] = {};
+        uint32_t h1 = (uint32_t)hash;
+        uint32_t h2 = (h1 >> 17) | (h1 << 15) | 1;
+        for (unsigned int i = 0; i < hashes_; ++i, h1 += h2) {
+            unsigned int bit = h1 >> 23;
+            pattern[bit / 64] |= (uint64_t)1 << (bit % 64);
+        }
+        uint64_t missing = 0;
+        for (unsigned int w = 0; w < BLOCK_BITS / 64; ++w) missing |= pattern[w] & ~block.words[w];
+        return missing == 0;
+    }
+
+    void clear() { blocks_.assign(blocks_.size(), Block()); }
+
+    size_t capacity() const { return capacity_; }
+    double falsePositiveRate() const { return falsePositiveRate_; }
+    unsigned int hashes() const { return hashes_; }
+    size_t memoryUsage() const { return blocks_.size() * sizeof(Block); }
+
+private:
+    struct alignas(64) Block {
+        uint64_t words[BLOCK_BITS / 64];
+
+        Block() : words() {}
+    };
+
+    // multiply-shift maps the high half of the hash onto [0, blocks)
+    size_t blockOf(uint64_t hash) const {
+        return (size_t)(((hash >> 32) * (uint64_t)blocks_.size()) >> 32);
+    }
+
+    size_t capacity_;
+    double falsePositiveRate_;
+    unsigned int hashes_;
+    std::vector<Block> blocks_;
+};
+
+
+// HashTable with a BlockedBloomFilter in front of it.
+//
+// Every key that is inserted is also added to the filter, and search and
+// remove ask the filter first: a key the filter has never seen is rejected
+// after one hash and one cache line, without walking a chain or comparing
+// strings. Hits pay for the filter check on top of the table lookup, so this
+// only pays off when many lookups miss.
+//
+// Removed keys stay in the filter and slowly raise its false positive rate.
+// The filter is rebuilt from the table's keys once removals since the last
+// rebuild reach a quarter of its capacity, and also when the table outgrows
+// the capacity it was sized for.
+template <class Key, class Value, class Hasher = WyHash, class KeyEqual = std::equal_to<>>
+class BloomFilteredHashTable {
+public:
+    explicit BloomFilteredHashTable(size_t expectedKeys = 1024, double falsePositiveRate = 0.01,
+                                    const Hasher& hasher = Hasher(), const KeyEqual& equal = KeyEqual())
+        : hasher_(hasher), table_(hasher, equal), filter_(expectedKeys, falsePositiveRate),
+          minCapacity_(expectedKeys), removals_(0), rejected_(0) {}
+
+    size_t size() const { return table_.size(); }
+    bool empty() const { return table_.empty(); }
+
+    template <class Q>
+    Value* search(const Q& key) {
+        if (!filter_.mayContain(hasher_(key))) {
+            rejected_++;
+            return nullptr;
+        }
+        return table_.search(key);
+    }
+
+    template <class Q>
+    bool contains(const Q& key) {
+        return search(key) != nullptr;
+    }
+
+    template <class K, class... Args>
+    std::pair<Value*, bool> try_emplace(K&& key, Args&&... args) {
+        uint64_t hash = hasher_(key);
+        std::pair<Value*, bool> result = table_.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        if (result.second) {
+            filter_.add(hash);
+            if (table_.size() > filter_.capacity()) rebuild();
+        }
+        return result;
+    }
+
+    template <class K, class... Args>
+    bool emplace(K&& key, Args&&... args) {
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+    }
+
+    bool insert(const Key& key, const Value& value) { return emplace(key, value); }
+
+    template <class K, class V>
+    std::pair<Value*, bool> insert_or_assign(K&& key, V&& value) {
+        uint64_t hash = hasher_(key);
+        std::pair<Value*, bool> result = table_.insert_or_assign(std::forward<K>(key), std::forward<V>(value));
+        if (result.second) {
+            filter_.add(hash);
+            if (table_.size() > filter_.capacity()) rebuild();
+        }
+        return result;
+    }
+
+    template <class Q>
+    bool remove(const Q& key) {
+        if (!filter_.mayContain(hasher_(key))) {
+            rejected_++;
+            return false;
+        }
+        if (!table_.remove(key)) return false;
+        if (++removals_ >= filter_.capacity() / 4) rebuild();
+        return true;
+    }
+
+    // Refills the filter from the keys in the table, sized for twice as many
+    // keys so the table can grow before the next rebuild.
+    void rebuild() {
+        size_t capacity = table_.size() * 2;
+        if (capacity < minCapacity_) capacity = minCapacity_;
+        filter_ = BlockedBloomFilter(capacity, filter_.falsePositiveRate());
+        table_.forEach([this](const Key& key, Value&) { filter_.add(hasher_(key)); });
+        removals_ = 0;
+    }
+
+    HashTable<Key, Value, Hasher, KeyEqual>& table() { return table_; }
+    const BlockedBloomFilter& filter() const { return filter_; }
+
+    // lookups and removes the filter answered without touching the table
+    size_t rejected() const { return rejected_; }
+
+private:
+    Hasher hasher_;
+    HashTable<Key, Value, Hasher, KeyEqual> table_;
+    BlockedBloomFilter filter_;
+    size_t minCapacity_;    // the filter is never sized below the initial expectation
+    size_t removals_;       // since the last rebuild
+    size_t rejected_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "concurrent-hash-table.h"
+#include "hash-table.h"
+using namespace std;
+
+// Throughput of ConcurrentHashTable against the plain HashTable behind one
+// mutex, for 1 to maxThreads threads and several read/write mixes.
+//
+// usage: concurrent-hash-table [maxThreads] [keys] [operationsPerThread]
+//
+// Every thread runs the same number of operations on random keys in
+// [0, keys). A read is a search; a write is an upsert or a remove, half each.
+// The tables start with every key present.
+
+
+// the way ingest threads share a HashTable today
+class LockedHashTable {
+public:
+	bool search(int key, int& value) {
+		lock_guard<mutex> lock(mutex_);
+		int* found = table_.search(key);
+		if (found == NULL) return false;
+		value = *found;
+		return true;
+	}
+
+	void insert_or_assign(int key, int value) {
+		lock_guard<mutex> lock(mutex_);
+		table_.insert_or_assign(key, value);
+	}
+
+	bool remove(int key) {
+		lock_guard<mutex> lock(mutex_);
+		return table_.remove(key);
+	}
+
+private:
+	mutex mutex_;
+	HashTable<int, int> table_;
+};
+
+// xorshift64: cheap enough not to show up in the measurement
+static uint64_t nextRandom(uint64_t& state) {
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+// returns millions of operations per second over all threads
+template <class Table>
+double run(Table& table, int threads, int keys, int operations, int writePercent) {
+	atomic<int> ready(0);
+	atomic<bool> go(false);
+	atomic<long long> hits(0);
+	vector<thread> workers;
+
+	for (int t = 0; t < threads; t++) {
+		workers.push_back(thread([&, t]() {
+			uint64_t state = 0x9E3779B97F4A7C15ull * (t + 1);
+			long long found = 0;
+			ready++;
+			while (!go.load()) this_thread::yield();
+
+			for (int i = 0; i < operations; i++) {
+				uint64_t r = nextRandom(state);
+				int key = (int)((r >> 16) % keys);
+				if ((int)(r % 100) >= writePercent) {
+					int value;
+					if (table.search(key, value)) found++;
+				} else if (r & 0x100) {
+					table.insert_or_assign(key, key);
+				} else {
+					table.remove(key);
+				}
+			}
+			hits += found;
+		}));
+	}
+
+	while (ready.load() < threads) this_thread::yield();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	go.store(true);
+	for (thread& worker : workers) worker.join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	return (double)threads * operations / seconds / 1e6;
+}
+
+template <class Table>
+void prefill(Table& table, int keys) {
+	for (int i = 0; i < keys; i++) table.insert_or_assign(i, i);
+}
+
+
+int main(int argc, char* argv[])
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : 32;
+	int keys = argc > 2 ? atoi(argv[2]) : 1 << 20;
+	int operations = argc > 3 ? atoi(argv[3]) : 200000;
+
+	// lock-free basics first
+	ConcurrentHashTable<string, string> names;
+	names.emplace("grace", "grace2@uw.ca");
+	names.insert_or_assign("grace", "grace.new@uw.ca");
+	string email;
+	if (names.search("grace", email)) cout << "grace: " << email << endl;
+	if (!names.remove("jack")) cout << "cannot remove when the key does not exist." << endl;
+
+	cout << keys << " keys, " << operations << " operations per thread, "
+	     << thread::hardware_concurrency() << " hardware threads" << endl;
+	cout << "throughput in million operations per second" << endl << endl;
+
+	int writeMixes[] = {0, 10, 50};
+	for (int writePercent : writeMixes) {
+		cout << (100 - writePercent) << "% reads / " << writePercent << "% writes" << endl;
+		cout << setw(8) << "threads" << setw(14) << "one mutex" << setw(14) << "concurrent" << endl;
+
+		for (int threads = 1; threads <= maxThreads; threads *= 2) {
+			LockedHashTable locked;
+			prefill(locked, keys);
+			ConcurrentHashTable<int, int> concurrent(keys * 2);
+			prefill(concurrent, keys);
+
+			double lockedRate = run(locked, threads, keys, operations, writePercent);
+			double concurrentRate = run(concurrent, threads, keys, operations, writePercent);
+			cout << setw(8) << threads << fixed << setprecision(2)
+			     << setw(14) << lockedRate << setw(14) << concurrentRate << endl;
+		}
+		cout << endl;
+	}
+
+	return 0;
+}
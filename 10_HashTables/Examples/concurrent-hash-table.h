@@ -0,0 +1,389 @@
+#ifndef HASH_TABLES_CONCURRENT_HASH_TABLE_H
+#define HASH_TABLES_CONCURRENT_HASH_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+
+// Epoch-based reclamation.
+//
+// A lock-free reader may still be walking a node that a writer has just
+// unlinked, so unlinked memory cannot be freed straight away. Readers pin the
+// current global epoch while they run; writers retire unlinked memory tagged
+// with the epoch at retire time. The global epoch only moves forward once every
+// pinned thread has seen it, so memory retired in epoch e is unreachable by
+// any reader once the global epoch reaches e + 2, and is freed then.
+class EpochReclaimer {
+public:
+    static const unsigned int MAX_THREADS = 256;
+    // a thread tries to advance the epoch and free memory every this many retires
+    static const size_t COLLECT_EVERY = 64;
+
+    // Pins the calling thread for its lifetime. Guards nest.
+    class Guard {
+    public:
+        explicit Guard(EpochReclaimer& reclaimer) : reclaimer_(reclaimer), slot_(threadIndex()) {
+            reclaimer_.enter(slot_);
+        }
+        ~Guard() { reclaimer_.leave(slot_); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochReclaimer& reclaimer_;
+        unsigned int slot_;
+    };
+
+    EpochReclaimer() : epoch_(1), slots_(new Slot[MAX_THREADS]) {}
+
+    // no thread may be using the owner any more
+    ~EpochReclaimer() {
+        for (unsigned int i = 0; i < MAX_THREADS; ++i) {
+            for (const Retired& item : slots_[i].retired) item.deleter(item.pointer);
+        }
+        delete[] slots_;
+    }
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // frees pointer with deleter once no reader can still see it.
+    // pointer must already be unreachable for readers that pin from now on.
+    void retire(void* pointer, void (*deleter)(void*)) {
+        Slot& slot = slots_[threadIndex()];
+        slot.retired.push_back(Retired{pointer, deleter, epoch_.load()});
+        if (slot.retired.size() % COLLECT_EVERY == 0) {
+            tryAdvance();
+            collect(slot);
+        }
+    }
+
+private:
+    static const uint64_t IDLE = ~(uint64_t)0;
+
+    struct Retired {
+        void* pointer;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    // one per thread, on its own cache line so pinning does not bounce lines
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch;
+        unsigned int depth;     // nesting of Guards, only touched by the owning thread
+        std::vector<Retired> retired;
+
+        Slot() : epoch(IDLE), depth(0) {}
+    };
+
+    // Small process-wide index per live thread, so each reclaimer can give a
+    // thread its own Slot without a map. Released when the thread exits.
+    static unsigned int threadIndex() {
+        struct Registration {
+            unsigned int index;
+
+            Registration() : index(0) {
+                for (;; index = (index + 1) % MAX_THREADS) {
+                    bool expected = false;
+                    if (taken()[index].compare_exchange_strong(expected, true)) return;
+                }
+            }
+            ~Registration() { taken()[index].store(false); }
+        };
+        thread_local Registration registration;
+        return registration.index;
+    }
+
+    static std::atomic<bool>* taken() {
+        static std::atomic<bool> indices[MAX_THREADS] = {};
+        return indices;
+    }
+
+    void enter(unsigned int index) {
+        Slot& slot = slots_[index];
+        if (slot.depth++ > 0) return;
+        // publish the epoch, then make sure it did not move in between, so the
+        // epoch we hold is never more than one behind the global one
+        uint64_t epoch;
+        do {
+            epoch = epoch_.load();
+            slot.epoch.store(epoch);
+        } while (epoch_.load() != epoch);
+    }
+
+    void leave(unsigned int index) {
+        Slot& slot = slots_[index];
+        if (--slot.depth == 0) slot.epoch.store(IDLE);
+    }
+
+    // the global epoch moves on only when every pinned thread is in it
+    void tryAdvance() {
+        uint64_t epoch = epoch_.load();
+        for (unsigned int i = 0; i < MAX_THREADS; ++i) {
+            uint64_t pinned = slots_[i].epoch.load();
+            if (pinned != IDLE && pinned != epoch) return;
+        }
+        epoch_.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void collect(Slot& slot) {
+        uint64_t epoch = epoch_.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.retired.size(); ++i) {
+            Retired item = slot.retired[i];
+            if (item.epoch + 2 <= epoch) item.deleter(item.pointer);
+            else slot.retired[kept++] = item;
+        }
+        slot.retired.resize(kept);
+    }
+
+    std::atomic<uint64_t> epoch_;
+    Slot* slots_;
+};
+
+
+// Separate chaining hash table that many threads can use at once.
+//
+// Writers (emplace, insert_or_assign, remove) lock one of STRIPES mutexes,
+// chosen by the key's hash, so writers of different stripes never wait for
+// each other. Readers take no lock at all: bucket heads and next pointers are
+// atomics, a node is fully built before it is published with a release store,
+// and a linked node is never modified. insert_or_assign therefore swaps in a
+// new node instead of writing to the old value.
+//
+// Unlinked nodes are handed to an EpochReclaimer and freed only once no reader
+// can still be walking them. For the same reason a search cannot return a
+// pointer into the table: it copies the value out, or calls a visitor while
+// the node is guaranteed to stay alive.
+//
+// When the table passes 75% full a writer locks every stripe and builds a
+// bucket array of twice the size with copies of all nodes, then publishes it.
+// Readers keep walking whichever array they loaded; the old one is retired as
+// a whole. The table never shrinks.
+template <class Key, class Value, class Hasher = WyHash, class KeyEqual = std::equal_to<>>
+class ConcurrentHashTable {
+public:
+    static const size_t MIN_CAPACITY = 64;
+    static const size_t STRIPES = 64;
+    static_assert(MIN_CAPACITY % STRIPES == 0, "every bucket must map to a single stripe");
+
+    explicit ConcurrentHashTable(size_t initialCapacity = MIN_CAPACITY, const Hasher& hasher = Hasher(),
+                                 const KeyEqual& equal = KeyEqual())
+        : hasher_(hasher), equal_(equal), size_(0) {
+        size_t cap = MIN_CAPACITY;
+        while (cap < initialCapacity) cap *= 2;
+        table_.store(new Table(cap));
+        capacity_.store(cap);
+    }
+
+    ~ConcurrentHashTable() {
+        deleteTable(table_.load());
+    }
+
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+    // Calls visitor(const Value&) if key exists and returns whether it did.
+    // Lock-free; the value stays valid for the duration of the call.
+    template <class Q, class Visitor>
+    bool visit(const Q& key, Visitor&& visitor) const {
+        EpochReclaimer::Guard guard(reclaimer_);
+        const Node* node = find(table_.load(std::memory_order_acquire), key, hasher_(key));
+        if (node == nullptr) return false;
+        visitor(node->value);
+        return true;
+    }
+
+    // Copies the value stored under key into result. Lock-free.
+    template <class Q>
+    bool search(const Q& key, Value& result) const {
+        return visit(key, [&result](const Value& value) { result = value; });
+    }
+
+    template <class Q>
+    bool contains(const Q& key) const {
+        return visit(key, [](const Value&) {});
+    }
+
+    // Returns false, without constructing anything, if the key already exists.
+    template <class K, class... Args>
+    bool emplace(K&& key, Args&&... args) {
+        uint64_t hash = hasher_(key);
+        {
+            std::lock_guard<std::mutex> lock(stripeOf(hash));
+            Table* table = table_.load(std::memory_order_relaxed);
+            std::atomic<Node*>& head = table->buckets[hash & (table->capacity - 1)];
+            if (find(table, key, hash) != nullptr) return false;
+
+            Node* node = new Node(hash, std::forward<K>(key), std::forward<Args>(args)...);
+            node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(node, std::memory_order_release);
+        }
+        growIfNeeded(size_.fetch_add(1, std::memory_order_relaxed) + 1);
+        return true;
+    }
+
+    bool insert(const Key& key, const Value& value) { return emplace(key, value); }
+
+    // Upsert. Returns true if a new item was inserted, false if an existing
+    // value was replaced (by a new node, readers still see the old one or the new one).
+    template <class K, class V>
+    bool insert_or_assign(K&& key, V&& value) {
+        uint64_t hash = hasher_(key);
+        {
+            EpochReclaimer::Guard guard(reclaimer_);
+            std::lock_guard<std::mutex> lock(stripeOf(hash));
+            Table* table = table_.load(std::memory_order_relaxed);
+            std::atomic<Node*>* link = findLink(table, key, hash);
+            Node* old = link->load(std::memory_order_relaxed);
+
+            Node* node = new Node(hash, std::forward<K>(key), std::forward<V>(value));
+            if (old != nullptr) {
+                node->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                link->store(node, std::memory_order_release);
+                reclaimer_.retire(old, &deleteNode);
+                return false;
+            }
+            std::atomic<Node*>& head = table->buckets[hash & (table->capacity - 1)];
+            node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            head.store(node, std::memory_order_release);
+        }
+        growIfNeeded(size_.fetch_add(1, std::memory_order_relaxed) + 1);
+        return true;
+    }
+
+    // Returns false if the key does not exist.
+    template <class Q>
+    bool remove(const Q& key) {
+        uint64_t hash = hasher_(key);
+        EpochReclaimer::Guard guard(reclaimer_);
+        std::lock_guard<std::mutex> lock(stripeOf(hash));
+        std::atomic<Node*>* link = findLink(table_.load(std::memory_order_relaxed), key, hash);
+        Node* node = link->load(std::memory_order_relaxed);
+        if (node == nullptr) return false;
+
+        // readers already on node can still follow its next pointer
+        link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+        reclaimer_.retire(node, &deleteNode);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        const uint64_t hash;
+        const Key key;
+        const Value value;
+
+        template <class K, class... Args>
+        Node(uint64_t h, K&& k, Args&&... args)
+            : next(nullptr), hash(h), key(std::forward<K>(k)), value(std::forward<Args>(args)...) {}
+    };
+
+    struct Table {
+        size_t capacity;            // power of two
+        std::atomic<Node*>* buckets;
+
+        explicit Table(size_t cap) : capacity(cap), buckets(new std::atomic<Node*>[cap]) {
+            for (size_t i = 0; i < cap; ++i) buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+        ~Table() { delete[] buckets; }
+    };
+
+    // each mutex on its own cache line, so neighbouring stripes do not share one
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+    static void deleteNode(void* node) { delete static_cast<Node*>(node); }
+
+    // a retired table owns the nodes still linked into it
+    static void deleteTable(void* pointer) {
+        Table* table = static_cast<Table*>(pointer);
+        for (size_t i = 0; i < table->capacity; ++i) {
+            Node* node = table->buckets[i].load(std::memory_order_relaxed);
+            while (node != nullptr) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+        delete table;
+    }
+
+    // the stripe is the low bits of the bucket index. capacities are multiples
+    // of STRIPES, so every bucket belongs to exactly one stripe, and a key keeps
+    // its stripe across resizes.
+    std::mutex& stripeOf(uint64_t hash) {
+        return stripes_[hash & (STRIPES - 1)].mutex;
+    }
+
+    template <class Q>
+    const Node* find(const Table* table, const Q& key, uint64_t hash) const {
+        const Node* node = table->buckets[hash & (table->capacity - 1)].load(std::memory_order_acquire);
+        while (node != nullptr && !(node->hash == hash && equal_(node->key, key)))
+            node = node->next.load(std::memory_order_acquire);
+        return node;
+    }
+
+    // the link that points at key's node, or the null link ending its chain.
+    // only called with the key's stripe locked.
+    template <class Q>
+    std::atomic<Node*>* findLink(Table* table, const Q& key, uint64_t hash) {
+        std::atomic<Node*>* link = &table->buckets[hash & (table->capacity - 1)];
+        Node* node;
+        while ((node = link->load(std::memory_order_relaxed)) != nullptr
+               && !(node->hash == hash && equal_(node->key, key)))
+            link = &node->next;
+        return link;
+    }
+
+    void growIfNeeded(size_t size) {
+        // not pinned, so the capacity is read from the table object only under the locks
+        if (size <= capacity_.load(std::memory_order_relaxed) / 4 * 3) return;
+
+        // stripes are always locked in index order, so two growers cannot deadlock
+        for (size_t i = 0; i < STRIPES; ++i) stripes_[i].mutex.lock();
+
+        Table* old = table_.load(std::memory_order_relaxed);
+        if (size_.load(std::memory_order_relaxed) > old->capacity / 4 * 3) {
+            // copy rather than relink: readers may still be walking the old chains
+            Table* table = new Table(old->capacity * 2);
+            for (size_t i = 0; i < old->capacity; ++i) {
+                for (Node* node = old->buckets[i].load(std::memory_order_relaxed); node != nullptr;
+                     node = node->next.load(std::memory_order_relaxed)) {
+                    Node* copy = new Node(node->hash, node->key, node->value);
+                    std::atomic<Node*>& head = table->buckets[node->hash & (table->capacity - 1)];
+                    copy->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    head.store(copy, std::memory_order_relaxed);
+                }
+            }
+            table_.store(table, std::memory_order_release);
+            capacity_.store(table->capacity, std::memory_order_relaxed);
+            reclaimer_.retire(old, &deleteTable);
+        }
+
+        for (size_t i = STRIPES; i > 0; --i) stripes_[i - 1].mutex.unlock();
+    }
+
+    Hasher hasher_;
+    KeyEqual equal_;
+    std::atomic<Table*> table_;
+    std::atomic<size_t> capacity_;  // mirrors table_->capacity
+    std::atomic<size_t> size_;
+    Stripe stripes_[STRIPES];
+    mutable EpochReclaimer reclaimer_;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "cuckoo-hash-table.h"
+#include "hash-table.h"
+using namespace std;
+
+// Records are keyed on idNumber. See cuckoo-hash-table.h for the bucket layout.
+
+// millions of lookups per second for the given ids, and how many were found
+template <class Lookup>
+double timeLookups(const vector<int>& ids, Lookup lookup, int& found) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	found = 0;
+	for (int id : ids)
+		if (lookup(id) != NULL) found++;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return ids.size() / seconds / 1e6;
+}
+
+
+int main()
+{
+	CuckooHashTable<> h;
+
+	h.insert(1000101, "jacob",  "jacob23@uw.ca");
+	h.insert(2001201, "shawn",  "shawn3@uw.ca");
+	h.insert(3003121, "max",  "maxmax@uw.ca");
+	h.insert(3004578, "grace",  "grace2@uw.ca");
+	h.insert(2001234, "andrew",  "andrew@uw.ca");
+	h.insert(5201863, "peter",  "peterw2@uw.ca");
+	h.insert(3005831, "emily",  "emily3@uw.ca");
+	h.insert(2203234, "mary",  "mary87@uw.ca");
+
+	if ( !h.insert(1000101, "jacob",  "jacob23@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.remove(123) )
+		cout << "cannot remove when the key does not exist." << endl;
+
+	Record* result = h.search(2001234);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	h.remove(2001234);
+	cout<< (h.search(2001234) == NULL ? "2001234 removed" : "2001234 still there") << endl;
+	result = h.search(2203234);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	// A/B against the chaining table: the same ids, hits and misses
+	const int n = 900000;
+	CuckooHashTable<> cuckoo;
+	HashTable<int, Record> chaining;
+	vector<int> present, missing;
+	for (int i = 0; i < n; i++) {
+		int id = 1000000 + i * 7;
+		cuckoo.insert(id, "member", "member@uw.ca");
+		chaining.emplace(id, id, "member", "member@uw.ca");
+		present.push_back(id);
+		missing.push_back(id + 3);
+	}
+	cout<< endl << n << " records, cuckoo load factor " << cuckoo.loadFactor()
+	    << " (" << cuckoo.capacity() << " slots)" << endl;
+
+	// the found counts are printed so the lookups cannot be optimized away
+	int found[4];
+	double cuckooHits = timeLookups(present, [&](int id) { return cuckoo.search(id); }, found[0]);
+	double chainingHits = timeLookups(present, [&](int id) { return chaining.search(id); }, found[1]);
+	double cuckooMisses = timeLookups(missing, [&](int id) { return cuckoo.search(id); }, found[2]);
+	double chainingMisses = timeLookups(missing, [&](int id) { return chaining.search(id); }, found[3]);
+
+	cout<< "hits:   cuckoo " << cuckooHits << " M/s, chaining " << chainingHits << " M/s ("
+	    << found[0] << " and " << found[1] << " found)" << endl;
+	cout<< "misses: cuckoo " << cuckooMisses << " M/s, chaining " << chainingMisses << " M/s ("
+	    << found[2] << " and " << found[3] << " found)" << endl;
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+#ifndef HASH_TABLES_CUCKOO_HASH_TABLE_H
+#define HASH_TABLES_CUCKOO_HASH_TABLE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "record.h"
+
+// Bucketized cuckoo hash table keyed on idNumber.
+//
+// Every key has exactly two candidate buckets, derived from two halves of one
+// 64-bit hash, and each bucket holds up to 4 keys. A bucket is 32 bytes (4
+// keys and 4 record indexes) aligned to 32, so it never straddles a cache
+// line: a lookup, hit or miss, reads at most two lines of the bucket array.
+// There are no chains, so the worst case is the same two buckets as the
+// average case. A hit then reads its record from the dense record array.
+//
+// Inserting into two full buckets searches breadth first for the shortest
+// path of moves that ends in a bucket with a free slot, then shifts each key
+// along that path to its other bucket. If no path is found within
+// MAX_SEARCH buckets (a cycle, or the table is simply too full) the table
+// rehashes with a new seed, doubling first if it is reasonably full.
+//
+// Hasher is a policy from hash-functions.h.
+template <class Hasher = WyHash>
+class CuckooHashTable {
+public:
+    static const unsigned int SLOTS_PER_BUCKET = 4;
+    static const unsigned int MIN_BUCKETS = 4;
+    // buckets visited by one eviction path search before giving up
+    static const unsigned int MAX_SEARCH = 512;
+
+    explicit CuckooHashTable(unsigned int initialCapacity = MIN_BUCKETS * SLOTS_PER_BUCKET,
+                             const Hasher& hasher = Hasher())
+        : hasher_(hasher), buckets_(nullptr), numBuckets_(0), mask_(0), seed_(0) {
+        unsigned int count = MIN_BUCKETS;
+        while (count * SLOTS_PER_BUCKET < initialCapacity) count *= 2;
+        allocate(count);
+    }
+
+    ~CuckooHashTable() { std::free(buckets_); }
+
+    CuckooHashTable(const CuckooHashTable&) = delete;
+    CuckooHashTable& operator=(const CuckooHashTable&) = delete;
+
+    unsigned int size() const { return records_.size(); }
+    unsigned int capacity() const { return numBuckets_ * SLOTS_PER_BUCKET; }
+
+    Record* search(int num) {
+        uint64_t hash = hashKey(num);
+        const Bucket& first = buckets_[firstBucket(hash)];
+        const Bucket& second = buckets_[secondBucket(hash)];
+        int slot = first.find(num);
+        if (slot >= 0) return &records_[first.index[slot] - 1];
+        slot = second.find(num);
+        if (slot >= 0) return &records_[second.index[slot] - 1];
+        return nullptr;
+    }
+
+    // Returns false (and leaves the table unchanged) if the key already exists.
+    bool insert(int num, const std::string& name, const std::string& email) {
+        if (search(num) != nullptr) return false;
+
+        records_.push_back(Record(num, name, email));
+        if (records_.size() * 10 > (size_t)capacity() * 9) rehash(numBuckets_ * 2);
+        while (!place(num, records_.size())) {
+            // no eviction path: a cycle, or too full for this seed
+            rehash(records_.size() * 2 > capacity() ? numBuckets_ * 2 : numBuckets_);
+        }
+        return true;
+    }
+
+    // Returns false if the key does not exist.
+    // The last record moves into the freed spot so the record array stays dense.
+    bool remove(int num) {
+        uint32_t* entry = findEntry(num);
+        if (entry == nullptr) return false;
+
+        uint32_t hole = *entry - 1;
+        *entry = 0;
+        uint32_t last = records_.size() - 1;
+        if (hole != last) {
+            records_[hole] = std::move(records_[last]);
+            *findEntry(records_[hole].idNumber) = hole + 1;
+        }
+        records_.pop_back();
+        return true;
+    }
+
+    // fraction of slots in use
+    double loadFactor() const { return (double)records_.size() / capacity(); }
+
+    // Bytes owned by the table itself (bucket and record arrays), not counting string heap buffers.
+    size_t memoryUsage() const {
+        return (size_t)numBuckets_ * sizeof(Bucket) + records_.capacity() * sizeof(Record);
+    }
+
+private:
+    struct alignas(32) Bucket {
+        int32_t key[SLOTS_PER_BUCKET];
+        // record index + 1, 0 marks a free slot
+        uint32_t index[SLOTS_PER_BUCKET];
+
+        int find(int num) const {
+            for (unsigned int i = 0; i < SLOTS_PER_BUCKET; ++i) {
+                if (index[i] != 0 && key[i] == num) return i;
+            }
+            return -1;
+        }
+
+        int freeSlot() const {
+            for (unsigned int i = 0; i < SLOTS_PER_BUCKET; ++i) {
+                if (index[i] == 0) return i;
+            }
+            return -1;
+        }
+    };
+    static_assert(sizeof(Bucket) == 32, "a bucket must fit in half a cache line");
+
+    // one step of the breadth-first eviction search
+    struct PathNode {
+        uint32_t bucket;
+        int parent;             // position of the parent in the search queue, -1 for a candidate bucket
+        unsigned int slot;      // slot of the parent bucket whose key would move here
+    };
+
+    uint64_t hashKey(int num) const {
+        return hashing::mixInteger(hasher_(num) ^ seed_);
+    }
+
+    uint32_t firstBucket(uint64_t hash) const { return (uint32_t)hash & mask_; }
+
+    // a different bucket from the first whenever there is more than one
+    uint32_t secondBucket(uint64_t hash) const {
+        uint32_t first = firstBucket(hash);
+        uint32_t second = (uint32_t)(hash >> 32) & mask_;
+        return second == first ? first ^ 1 : second;
+    }
+
+    uint32_t otherBucket(int num, uint32_t bucket) const {
+        uint64_t hash = hashKey(num);
+        uint32_t first = firstBucket(hash);
+        return bucket == first ? secondBucket(hash) : first;
+    }
+
+    uint32_t* findEntry(int num) {
+        uint64_t hash = hashKey(num);
+        Bucket& first = buckets_[firstBucket(hash)];
+        int slot = first.find(num);
+        if (slot >= 0) return &first.index[slot];
+        Bucket& second = buckets_[secondBucket(hash)];
+        slot = second.find(num);
+        return slot < 0 ? nullptr : &second.index[slot];
+    }
+
+    // Puts a key known not to be in the table into one of its buckets, moving
+    // other keys along the shortest eviction path if both are full.
+    // Returns false, with the table unchanged, if no path was found.
+    bool place(int num, uint32_t index) {
+        uint64_t hash = hashKey(num);
+        std::vector<PathNode> queue;
+        queue.push_back(PathNode{firstBucket(hash), -1, 0});
+        queue.push_back(PathNode{secondBucket(hash), -1, 0});
+
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const Bucket& bucket = buckets_[queue[head].bucket];
+            int free = bucket.freeSlot();
+            if (free >= 0) {
+                Bucket& target = buckets_[queue[moveAlong(queue, head, free)].bucket];
+                target.key[free] = num;
+                target.index[free] = index;
+                return true;
+            }
+            if (queue.size() >= MAX_SEARCH) continue;
+
+            for (unsigned int i = 0; i < SLOTS_PER_BUCKET; ++i) {
+                uint32_t next = otherBucket(bucket.key[i], queue[head].bucket);
+                if (!onPath(queue, head, next)) queue.push_back(PathNode{next, (int)head, i});
+            }
+        }
+        return false;
+    }
+
+    // a path must not pass through the same bucket twice, or a later move
+    // could overwrite a slot an earlier move just filled
+    static bool onPath(const std::vector<PathNode>& queue, size_t node, uint32_t bucket) {
+        for (int at = (int)node; at >= 0; at = queue[at].parent) {
+            if (queue[at].bucket == bucket) return true;
+        }
+        return false;
+    }
+
+    // Shifts keys from the free end of the path back towards the candidate
+    // bucket: each key moves into the slot its child just made free. Returns
+    // the candidate bucket's queue position, with free set to its freed slot.
+    size_t moveAlong(const std::vector<PathNode>& queue, size_t node, int& free) {
+        while (queue[node].parent >= 0) {
+            const PathNode& step = queue[node];
+            Bucket& from = buckets_[queue[step.parent].bucket];
+            Bucket& to = buckets_[step.bucket];
+            to.key[free] = from.key[step.slot];
+            to.index[free] = from.index[step.slot];
+            from.index[step.slot] = 0;
+            free = step.slot;
+            node = step.parent;
+        }
+        return node;
+    }
+
+    // rebuilds the buckets from the record array with a fresh seed, doubling
+    // the bucket count again until every key finds a place
+    void rehash(unsigned int newBuckets) {
+        while (true) {
+            std::free(buckets_);
+            allocate(newBuckets);
+            seed_ = hashing::mixInteger(seed_ + 0x9E3779B97F4A7C15ull);
+
+            bool placed = true;
+            // the record being inserted may not be placed yet; it is placed by the caller
+            for (uint32_t i = 0; i + 1 < records_.size() && placed; ++i) {
+                placed = place(records_[i].idNumber, i + 1);
+            }
+            if (placed) return;
+            if (records_.size() * 2 > capacity()) newBuckets *= 2;
+        }
+    }
+
+    void allocate(unsigned int count) {
+        buckets_ = static_cast<Bucket*>(aligned_alloc(alignof(Bucket), (size_t)count * sizeof(Bucket)));
+        if (buckets_ == nullptr) throw std::bad_alloc();
+        for (unsigned int i = 0; i < count; ++i) {
+            for (unsigned int s = 0; s < SLOTS_PER_BUCKET; ++s) buckets_[i].index[s] = 0;
+        }
+        numBuckets_ = count;
+        mask_ = count - 1;
+    }
+
+    Hasher hasher_;
+    Bucket* buckets_;
+    unsigned int numBuckets_;   // power of two
+    uint32_t mask_;
+    uint64_t seed_;             // changed on every rehash, so a cycle does not repeat
+    std::vector<Record> records_;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "disk-hash-index.h"
+using namespace std;
+
+// Records are keyed on idNumber and kept in <path>.idx and <path>.heap.
+// See disk-hash-index.h for the file layout and the write ordering.
+//
+// usage: disk-hash-index [path] [records]
+//
+// The first run loads the records; later runs reopen the files and go
+// straight to lookups.
+
+static double millisecondsSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+
+int main(int argc, char* argv[])
+{
+	string path = argc > 1 ? argv[1] : "members";
+	int records = argc > 2 ? atoi(argv[2]) : 1000000;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	{
+		// bulk load without a sync per record, then one sync at close
+		DiskHashIndex loader(path, records, false);
+		if (loader.size() == 0) {
+			for (int i = 0; i < records; i++)
+				loader.insert(i, "member" + to_string(i), "member" + to_string(i) + "@uw.ca");
+			loader.close();
+			cout << "loaded " << records << " records in " << millisecondsSince(start) << " ms" << endl;
+		}
+	}
+
+	start = chrono::steady_clock::now();
+	DiskHashIndex h(path);
+	cout << "opened " << h.size() << " records (" << h.buckets() << " buckets, " << h.pages()
+	     << " pages) in " << millisecondsSince(start) << " ms" << endl;
+
+	Record result;
+	if (h.search(4242, result))
+		cout << result.idNumber << ", " << result.idName << ", " << result.emailAddress << endl;
+
+	// single writes are durable when insert and remove return
+	h.remove(3003121);
+	if (h.insert(3003121, "max", "maxmax@uw.ca"))
+		cout << "inserted 3003121" << endl;
+	if ( !h.insert(3003121, "max", "maxmax@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.remove(-1) )
+		cout << "cannot remove when the key does not exist." << endl;
+	if (h.search(3003121, result))
+		cout << result.idNumber << ", " << result.idName << ", " << result.emailAddress << endl;
+
+	start = chrono::steady_clock::now();
+	int found = 0;
+	const int lookups = 200000;
+	for (int i = 0; i < lookups; i++)
+		if (h.search((int)((i * 2654435761u) % (unsigned int)records), result)) found++;
+	cout << lookups << " random lookups (" << found << " found) in " << millisecondsSince(start) << " ms" << endl;
+
+	return 0;
+}
@@ -0,0 +1,404 @@
+#ifndef HASH_TABLES_DISK_HASH_INDEX_H
+#define HASH_TABLES_DISK_HASH_INDEX_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash-functions.h"
+#include "record.h"
+
+// Persistent hash index of records keyed on idNumber (POSIX only).
+//
+// Two files make up one index:
+//   <path>.idx   the hash index, memory-mapped. Page 0 is a header, pages
+//                1..numBuckets are the bucket pages, and overflow pages are
+//                appended after them when a bucket fills up.
+//   <path>.heap  the records, append-only. An index entry stores the offset
+//                and length of its record, so a hit costs one pread.
+//
+// Every page is PAGE_SIZE bytes: a small header (entry count, next overflow
+// page) followed by fixed-size entries {idNumber, record length, heap offset}.
+// Pages are referenced by number, never by pointer, so the mapping can move
+// when the file grows.
+//
+// Opening an index maps the file and reads the header, nothing else, so it is
+// instant however many records there are. The kernel pages buckets in on
+// demand, so the data can be larger than RAM while hot buckets and records
+// stay in the page cache.
+//
+// Crash consistency comes from write ordering. With syncEachWrite (the
+// default) every insert
+//   1. appends the record to the heap and fdatasyncs it,
+//   2. writes the entry into an unused slot and msyncs the page,
+//   3. only then bumps the page's entry count (or, when reusing a deleted
+//      slot, sets the heap offset last) and msyncs again,
+// so after a crash an entry is either absent or points at a complete record.
+// A new overflow page is initialised and counted in the header before the
+// page that links to it is updated. A remove overwrites the entry's offset
+// with TOMBSTONE in one aligned 8-byte store.
+//
+// Without syncEachWrite, nothing is forced to disk until sync() or close;
+// each heap record carries a checksum so that an entry written back before
+// its record is read as missing instead of as garbage.
+//
+// The bucket count is fixed when the index is created, from expectedRecords.
+// Growing past that only makes overflow chains longer. Removed records
+// stay in the heap; there is no compaction.
+class DiskHashIndex {
+public:
+    static const uint32_t PAGE_SIZE = 4096;
+    static const uint64_t TOMBSTONE = ~(uint64_t)0;
+
+    explicit DiskHashIndex(const std::string& path, unsigned int expectedRecords = 1 << 16,
+                           bool syncEachWrite = true)
+        : indexFd_(-1), heapFd_(-1), map_(nullptr), mappedPages_(0), heapSize_(0), recordCount_(0),
+          syncEachWrite_(syncEachWrite) {
+        indexFd_ = ::open((path + ".idx").c_str(), O_RDWR | O_CREAT, 0644);
+        if (indexFd_ < 0) fail("cannot open " + path + ".idx");
+        heapFd_ = ::open((path + ".heap").c_str(), O_RDWR | O_CREAT, 0644);
+        if (heapFd_ < 0) fail("cannot open " + path + ".heap");
+
+        if (fileSize(indexFd_) == 0) create(expectedRecords);
+        else load();
+    }
+
+    ~DiskHashIndex() {
+        try {
+            close();
+        } catch (const std::system_error&) {
+            // nothing to report to from a destructor; call close() to see errors
+        }
+    }
+
+    DiskHashIndex(const DiskHashIndex&) = delete;
+    DiskHashIndex& operator=(const DiskHashIndex&) = delete;
+
+    uint64_t size() const { return recordCount_; }
+    uint32_t buckets() const { return header()->numBuckets; }
+    uint32_t pages() const { return header()->numPages; }
+    uint64_t heapBytes() const { return heapSize_; }
+
+    // Copies the record stored under num into result. Returns false if there
+    // is none, or if its heap record is incomplete.
+    bool search(int num, Record& result) const {
+        Slot slot = find(num);
+        if (slot.page == 0) return false;
+        const Entry& entry = page(slot.page)->entries[slot.index];
+        return readRecord(entry.offset, entry.length, result) && result.idNumber == num;
+    }
+
+    // Returns false (and writes nothing) if the key already exists.
+    bool insert(int num, const std::string& name, const std::string& email) {
+        Slot slot = find(num);
+        if (slot.page != 0) return false;
+
+        uint32_t length;
+        uint64_t offset = appendRecord(num, name, email, length);
+
+        if (slot.tombstonePage != 0) {
+            // reused slot: it only becomes live with the final offset store
+            Entry& entry = page(slot.tombstonePage)->entries[slot.tombstoneIndex];
+            entry.key = num;
+            entry.length = length;
+            syncPage(slot.tombstonePage);
+            entry.offset = offset;
+            syncPage(slot.tombstonePage);
+        } else {
+            uint32_t target = slot.lastPage;
+            if (page(target)->count == ENTRIES_PER_PAGE) target = addOverflowPage(target);
+
+            Page* p = page(target);
+            Entry& entry = p->entries[p->count];
+            entry.key = num;
+            entry.length = length;
+            entry.offset = offset;
+            syncPage(target);
+            // publishing the count is what makes the entry visible
+            p->count++;
+            syncPage(target);
+        }
+        recordCount_++;
+        return true;
+    }
+
+    // Returns false if the key does not exist. The record stays in the heap.
+    bool remove(int num) {
+        Slot slot = find(num);
+        if (slot.page == 0) return false;
+
+        page(slot.page)->entries[slot.index].offset = TOMBSTONE;
+        syncPage(slot.page);
+        recordCount_--;
+        return true;
+    }
+
+    // Forces everything written so far to disk: heap first, then the index.
+    void sync() {
+        if (map_ == nullptr) return;
+        if (::fdatasync(heapFd_) != 0) fail("cannot sync heap");
+        if (::msync(map_, (size_t)header()->numPages * PAGE_SIZE, MS_SYNC) != 0) fail("cannot sync index");
+    }
+
+    // Syncs, then marks the index as cleanly closed so the next open can trust
+    // the header's counters without a recovery scan.
+    void close() {
+        if (map_ != nullptr) {
+            sync();
+            header()->recordCount = recordCount_;
+            header()->heapSize = heapSize_;
+            header()->clean = 1;
+            syncPage(0, true);
+            ::munmap(map_, (size_t)mappedPages_ * PAGE_SIZE);
+            map_ = nullptr;
+        }
+        if (indexFd_ >= 0) ::close(indexFd_);
+        if (heapFd_ >= 0) ::close(heapFd_);
+        indexFd_ = heapFd_ = -1;
+    }
+
+private:
+    static const uint64_t MAGIC = 0x3158444948415344ull;    // "DSAHIDX1"
+    static const uint32_t VERSION = 1;
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t pageSize;
+        uint32_t numBuckets;    // power of two
+        uint32_t numPages;      // initialised pages, header and bucket pages included
+        uint32_t clean;         // 1 if the counters below were written by close()
+        uint32_t reserved;
+        uint64_t recordCount;
+        uint64_t heapSize;
+    };
+
+    struct Entry {
+        int32_t key;
+        uint32_t length;        // heap record length in bytes
+        uint64_t offset;        // heap offset, TOMBSTONE once removed
+    };
+
+    // a 16 byte page header, then entries
+    static const uint32_t ENTRIES_PER_PAGE = (PAGE_SIZE - 16) / sizeof(Entry);
+
+    struct Page {
+        uint32_t count;         // entries in use, live or removed
+        uint32_t overflow;      // next page of the bucket, 0 for none
+        uint64_t reserved;
+        Entry entries[ENTRIES_PER_PAGE];
+    };
+    static_assert(sizeof(Page) <= PAGE_SIZE, "page layout must fit in a page");
+
+    // where find stopped. page is 0 if num was not found (page 0 is the header)
+    struct Slot {
+        uint32_t page;
+        uint32_t index;
+        uint32_t lastPage;          // last page of the bucket's chain
+        uint32_t tombstonePage;     // first reusable slot on the chain, if any
+        uint32_t tombstoneIndex;
+    };
+
+    // heap record: checksum, idNumber, name length, name, email
+    static const uint32_t RECORD_HEADER = 12;
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static uint64_t fileSize(int fd) {
+        struct stat info;
+        if (::fstat(fd, &info) != 0) fail("cannot stat");
+        return (uint64_t)info.st_size;
+    }
+
+    Header* header() const { return reinterpret_cast<Header*>(map_); }
+    Page* page(uint32_t number) const { return reinterpret_cast<Page*>(map_ + (size_t)number * PAGE_SIZE); }
+
+    uint32_t bucketPage(int num) const {
+        return 1 + (uint32_t)(hashing::mixInteger((uint32_t)num) & (header()->numBuckets - 1));
+    }
+
+    Slot find(int num) const {
+        Slot slot = {0, 0, 0, 0, 0};
+        for (uint32_t number = bucketPage(num); number != 0; number = page(number)->overflow) {
+            const Page* p = page(number);
+            slot.lastPage = number;
+            for (uint32_t i = 0; i < p->count; ++i) {
+                const Entry& entry = p->entries[i];
+                if (entry.offset == TOMBSTONE) {
+                    if (slot.tombstonePage == 0) {
+                        slot.tombstonePage = number;
+                        slot.tombstoneIndex = i;
+                    }
+                } else if (entry.key == num) {
+                    slot.page = number;
+                    slot.index = i;
+                    return slot;
+                }
+            }
+        }
+        return slot;
+    }
+
+    // msync works on whole system pages, which PAGE_SIZE is a multiple of on
+    // the usual 4 KiB systems; on larger ones the enclosing page is synced.
+    void syncPage(uint32_t number, bool force = false) {
+        if (!syncEachWrite_ && !force) return;
+        size_t systemPage = (size_t)::sysconf(_SC_PAGESIZE);
+        size_t start = (size_t)number * PAGE_SIZE / systemPage * systemPage;
+        size_t end = (size_t)(number + 1) * PAGE_SIZE;
+        if (::msync(map_ + start, end - start, MS_SYNC) != 0) fail("cannot sync index page");
+    }
+
+    // maps at least pages pages of the index file, growing the file if needed
+    void mapPages(uint32_t pages) {
+        if (map_ != nullptr && pages <= mappedPages_) return;
+        // grow by an eighth at a time so overflow pages do not remap every time
+        uint32_t target = mappedPages_ + mappedPages_ / 8;
+        if (target < pages) target = pages;
+
+        if (fileSize(indexFd_) < (uint64_t)target * PAGE_SIZE
+            && ::ftruncate(indexFd_, (off_t)target * PAGE_SIZE) != 0) fail("cannot grow index");
+        if (map_ != nullptr) ::munmap(map_, (size_t)mappedPages_ * PAGE_SIZE);
+
+        void* map = ::mmap(nullptr, (size_t)target * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, indexFd_, 0);
+        if (map == MAP_FAILED) {
+            map_ = nullptr;
+            fail("cannot map index");
+        }
+        map_ = static_cast<char*>(map);
+        mappedPages_ = target;
+    }
+
+    void create(unsigned int expectedRecords) {
+        // aim for bucket pages about 70% full at the expected size
+        uint32_t numBuckets = 1;
+        while ((uint64_t)numBuckets * ENTRIES_PER_PAGE * 7 / 10 < expectedRecords) numBuckets *= 2;
+
+        // bucket pages start zeroed (count 0, no overflow) in the new file
+        mapPages(1 + numBuckets);
+        std::memset(map_, 0, PAGE_SIZE);
+        Header* h = header();
+        h->version = VERSION;
+        h->pageSize = PAGE_SIZE;
+        h->numBuckets = numBuckets;
+        h->numPages = 1 + numBuckets;
+        h->clean = 0;
+        if (::msync(map_, (size_t)h->numPages * PAGE_SIZE, MS_SYNC) != 0) fail("cannot sync index");
+        // the magic goes in last: a header without it is an unfinished index
+        h->magic = MAGIC;
+        syncPage(0, true);
+    }
+
+    void load() {
+        Header stored;
+        if (::pread(indexFd_, &stored, sizeof(stored), 0) != (ssize_t)sizeof(stored)
+            || stored.magic != MAGIC || stored.version != VERSION || stored.pageSize != PAGE_SIZE) {
+            errno = EINVAL;
+            fail("not a disk hash index");
+        }
+
+        mapPages(stored.numPages);
+        if (stored.clean) {
+            recordCount_ = stored.recordCount;
+            heapSize_ = stored.heapSize;
+        } else {
+            recover();
+        }
+        // while open, the counters in the header are stale
+        header()->clean = 0;
+        syncPage(0, true);
+    }
+
+    // After a crash: pages past numPages were never linked, heap bytes past the
+    // last record an entry points at were never referenced, and the record
+    // count has to be recounted from the entries.
+    void recover() {
+        Header* h = header();
+        recordCount_ = 0;
+        uint64_t heapEnd = 0;
+        for (uint32_t number = 1; number < h->numPages; ++number) {
+            const Page* p = page(number);
+            for (uint32_t i = 0; i < p->count; ++i) {
+                const Entry& entry = p->entries[i];
+                if (entry.offset == TOMBSTONE) continue;
+                recordCount_++;
+                if (entry.offset + entry.length > heapEnd) heapEnd = entry.offset + entry.length;
+            }
+        }
+        heapSize_ = heapEnd;
+        if (::ftruncate(heapFd_, (off_t)heapSize_) != 0) fail("cannot truncate heap");
+    }
+
+    // links a fresh page after last and returns its number
+    uint32_t addOverflowPage(uint32_t last) {
+        uint32_t number = header()->numPages;
+        mapPages(number + 1);
+        std::memset(page(number), 0, PAGE_SIZE);
+        syncPage(number);
+        header()->numPages = number + 1;
+        syncPage(0);
+        page(last)->overflow = number;
+        syncPage(last);
+        return number;
+    }
+
+    uint64_t appendRecord(int num, const std::string& name, const std::string& email, uint32_t& length) {
+        length = RECORD_HEADER + name.size() + email.size();
+        std::vector<char> buffer(length);
+        int32_t id = num;
+        uint32_t nameLength = name.size();
+        std::memcpy(&buffer[4], &id, 4);
+        std::memcpy(&buffer[8], &nameLength, 4);
+        std::memcpy(&buffer[RECORD_HEADER], name.data(), name.size());
+        std::memcpy(&buffer[RECORD_HEADER + name.size()], email.data(), email.size());
+        uint32_t checksum = checksumOf(buffer.data(), length);
+        std::memcpy(&buffer[0], &checksum, 4);
+
+        uint64_t offset = heapSize_;
+        if (::pwrite(heapFd_, buffer.data(), length, (off_t)offset) != (ssize_t)length) fail("cannot append record");
+        if (syncEachWrite_ && ::fdatasync(heapFd_) != 0) fail("cannot sync heap");
+        heapSize_ += length;
+        return offset;
+    }
+
+    bool readRecord(uint64_t offset, uint32_t length, Record& result) const {
+        if (length < RECORD_HEADER) return false;
+        std::vector<char> buffer(length);
+        if (::pread(heapFd_, buffer.data(), length, (off_t)offset) != (ssize_t)length) return false;
+
+        uint32_t checksum, nameLength;
+        int32_t id;
+        std::memcpy(&checksum, &buffer[0], 4);
+        std::memcpy(&id, &buffer[4], 4);
+        std::memcpy(&nameLength, &buffer[8], 4);
+        if (checksum != checksumOf(buffer.data(), length) || nameLength > length - RECORD_HEADER) return false;
+
+        result.idNumber = id;
+        result.idName.assign(&buffer[RECORD_HEADER], nameLength);
+        result.emailAddress.assign(&buffer[RECORD_HEADER + nameLength], length - RECORD_HEADER - nameLength);
+        return true;
+    }
+
+    // covers everything after the checksum field itself
+    static uint32_t checksumOf(const char* record, uint32_t length) {
+        return (uint32_t)hashing::wyhash(record + 4, length - 4, MAGIC);
+    }
+
+    int indexFd_;
+    int heapFd_;
+    char* map_;
+    uint32_t mappedPages_;  // pages mapped, at least header()->numPages
+    uint64_t heapSize_;     // end of the last appended record
+    uint64_t recordCount_;
+    bool syncEachWrite_;
+};
+
+#endif
@@ -0,0 +1,461 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <malloc.h>
+#include <memory>
+#include <unistd.h>
+#include "hash-table.h"
+#include "open-addressing.h"
+#include "swiss-table.h"
+#include "cuckoo-hash-table.h"
+#include "concurrent-hash-table.h"
+#include "record-store.h"
+#include "bloom-filter.h"
+#include "disk-hash-index.h"
+using namespace std;
+
+// Benchmark of every example hash table on the same workloads.
+//
+// usage: hash-bench [keys=N] [ops=N] [workload=NAME] [mix=NAME] [table=NAME] [histograms=1]
+//
+//   keys        records in the table before the measured operations (default 200000)
+//   ops         measured operations per run (default 1000000)
+//   workload    uniform | zipfian | sequential | stepped | names | anagrams | all
+//   mix         read | miss | mixed | write | all
+//   table       one table name from the list below, or all
+//   histograms  print chain / probe length histograms after each build
+//
+// Integer workloads run on the tables keyed on idNumber, string workloads on
+// the tables keyed on idName. Every table of a run sees exactly the same
+// operation sequence.
+//
+// Each run builds the table twice: once for an untimed pass that gives
+// ops/sec, and once for a pass that times every operation on its own for the
+// latency percentiles (which therefore include the clock's own overhead).
+// Bytes per entry is the heap growth while building, divided by keys, and
+// includes string buffers.
+//
+// "disk" is the DiskHashIndex, on a fresh pair of files in a temporary
+// directory for every build, without syncEachWrite: with it every write
+// waits for the device, which would measure the disk rather than the table.
+// Its pages are memory-mapped, not on the heap, so its bytes per entry only
+// counts what little it mallocs.
+
+
+// ---- workloads
+
+struct Workload {
+	string name;
+	bool stringKeys;
+	bool zipfian;           // accesses follow a Zipf distribution over the live keys
+	vector<int> ids;        // integer workloads: the key pool
+	vector<string> names;   // string workloads: the key pool
+};
+
+// Pools hold keys + extra keys: the first `keys` start in the table, the rest
+// are inserted by the operations or looked up as misses.
+Workload makeWorkload(const string& name, int keys, int extra) {
+	Workload w;
+	w.name = name;
+	w.stringKeys = (name == "names" || name == "anagrams");
+	w.zipfian = (name == "zipfian");
+	int total = keys + extra;
+	mt19937 random(42);
+
+	if (name == "uniform" || name == "zipfian") {
+		// distinct random ids
+		vector<int> ids;
+		while ((int)ids.size() < total) {
+			for (int i = (int)ids.size(); i < total; i++) ids.push_back((int)(random() & 0x7FFFFFFF));
+			sort(ids.begin(), ids.end());
+			ids.erase(unique(ids.begin(), ids.end()), ids.end());
+		}
+		shuffle(ids.begin(), ids.end(), random);
+		w.ids = ids;
+	} else if (name == "sequential") {
+		for (int i = 0; i < total; i++) w.ids.push_back(1000000 + i);
+	} else if (name == "stepped") {
+		// adversarial for weak integer hashes: the low 16 bits are almost all zero
+		for (int i = 0; i < total; i++) w.ids.push_back((int)(((unsigned int)i << 16) & 0x7FFFFFFF) + (i >> 15));
+		shuffle(w.ids.begin(), w.ids.end(), random);
+	} else if (name == "names") {
+		static const char* first[] = {"olivia", "liam", "emma", "noah", "amelia", "oliver", "ava", "elijah",
+		                              "sophia", "james", "isabella", "lucas", "mia", "henry", "grace", "jacob"};
+		static const char* last[] = {"smith", "johnson", "williams", "brown", "jones", "garcia", "miller",
+		                             "davis", "wilson", "anderson", "taylor", "thomas", "moore", "martin"};
+		for (int i = 0; i < total; i++)
+			w.names.push_back(string(first[i % 16]) + "." + last[(i / 16) % 14] + to_string(i / 224));
+		shuffle(w.names.begin(), w.names.end(), random);
+	} else if (name == "anagrams") {
+		// adversarial for additive string hashes: every key has the same letters
+		string letters = "abcdefghijkl";
+		for (int i = 0; i < total; i++) {
+			w.names.push_back(letters);
+			next_permutation(letters.begin(), letters.end());
+		}
+		shuffle(w.names.begin(), w.names.end(), random);
+	} else {
+		cerr << "unknown workload " << name << endl;
+		exit(1);
+	}
+	return w;
+}
+
+// ---- operation sequences
+
+enum OpType { SEARCH, INSERT, REMOVE };
+
+struct Op {
+	OpType type;
+	int key;        // index into the workload's key pool
+};
+
+struct Mix {
+	string name;
+	int searchPercent;
+	int insertPercent;  // the rest are removes
+	bool misses;        // searches look for keys that are not in the table
+};
+
+// Zipf(s) over ranks [0, n): inverse of a precomputed CDF
+class ZipfGenerator {
+public:
+	ZipfGenerator(int n, double s) : cdf_(n) {
+		double sum = 0;
+		for (int i = 0; i < n; i++) cdf_[i] = (sum += 1.0 / pow(i + 1, s));
+		for (double& c : cdf_) c /= sum;
+	}
+
+	int operator()(mt19937& random) {
+		double u = uniform_real_distribution<double>(0, 1)(random);
+		return (int)(lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+	}
+
+private:
+	vector<double> cdf_;
+};
+
+// Simulates the live key set so every table gets the same valid sequence:
+// searches pick a live key (or an absent one for misses), inserts take an
+// absent key, removes take a live one.
+vector<Op> makeOps(const Workload& w, const Mix& mix, int keys, int count) {
+	int total = w.stringKeys ? (int)w.names.size() : (int)w.ids.size();
+	vector<int> live, absent;
+	for (int i = 0; i < keys; i++) live.push_back(i);
+	for (int i = keys; i < total; i++) absent.push_back(i);
+
+	mt19937 random(7);
+	ZipfGenerator zipf(w.zipfian ? keys : 1, 0.99);
+	vector<Op> ops;
+	ops.reserve(count);
+	for (int i = 0; i < count; i++) {
+		int roll = (int)(random() % 100);
+		if (roll < mix.searchPercent || live.empty() || absent.empty()) {
+			if (mix.misses) {
+				ops.push_back(Op{SEARCH, absent[random() % absent.size()]});
+			} else {
+				int rank = w.zipfian ? zipf(random) : (int)(random() % live.size());
+				ops.push_back(Op{SEARCH, live[rank % live.size()]});
+			}
+		} else if (roll < mix.searchPercent + mix.insertPercent) {
+			size_t at = random() % absent.size();
+			ops.push_back(Op{INSERT, absent[at]});
+			live.push_back(absent[at]);
+			absent[at] = absent.back();
+			absent.pop_back();
+		} else {
+			size_t at = random() % live.size();
+			ops.push_back(Op{REMOVE, live[at]});
+			absent.push_back(live[at]);
+			live[at] = live.back();
+			live.pop_back();
+		}
+	}
+	return ops;
+}
+
+// ---- tables
+//
+// Every adapter takes (key, id): for integer workloads both are the id, for
+// string workloads the key is idName and the id is its index in the pool.
+
+string nameOf(int id) { return "member" + to_string(id); }
+string emailOf(const string& name) { return name + "@uw.ca"; }
+
+struct ChainingById {
+	static const char* name() { return "chaining"; }
+	HashTable<int, Record> table;
+	bool insert(int key, int) { return table.emplace(key, key, nameOf(key), emailOf(nameOf(key))); }
+	bool find(int key) { return table.search(key) != NULL; }
+	bool remove(int key) { return table.remove(key); }
+	void histogram(const vector<int>& keys) {
+		printBucketHistogram("  chains", bucketHistogram(keys, WyHash(), table.capacity()));
+	}
+};
+
+struct CuckooById {
+	static const char* name() { return "cuckoo"; }
+	CuckooHashTable<> table;
+	bool insert(int key, int) { return table.insert(key, nameOf(key), emailOf(nameOf(key))); }
+	bool find(int key) { return table.search(key) != NULL; }
+	bool remove(int key) { return table.remove(key); }
+	void histogram(const vector<int>&) {
+		cout << "  load factor " << table.loadFactor() << ", at most 2 buckets per lookup" << endl;
+	}
+};
+
+struct ConcurrentById {
+	static const char* name() { return "concurrent"; }
+	ConcurrentHashTable<int, Record> table;
+	bool insert(int key, int) { return table.emplace(key, key, nameOf(key), emailOf(nameOf(key))); }
+	bool find(int key) { return table.contains(key); }
+	bool remove(int key) { return table.remove(key); }
+	void histogram(const vector<int>& keys) {
+		printBucketHistogram("  chains", bucketHistogram(keys, WyHash(), table.capacity()));
+	}
+};
+
+struct StoreById {
+	static const char* name() { return "record-store"; }
+	RecordStore<> store;
+	bool insert(int key, int) { return store.insert(key, nameOf(key), emailOf(nameOf(key))); }
+	bool find(int key) { return store.findById(key) != NULL; }
+	bool remove(int key) { return store.removeById(key); }
+	void histogram(const vector<int>&) {}
+};
+
+struct DiskById {
+	static const char* name() { return "disk"; }
+	// the bucket count is fixed when the index is created, so main sizes it
+	// for every record a run can reach
+	static unsigned int expectedRecords;
+	string dir;
+	unique_ptr<DiskHashIndex> table;
+	Record found;
+	DiskById() : dir(makeTempDir()), table(new DiskHashIndex(dir + "/index", expectedRecords, false)) {}
+	~DiskById() {
+		table.reset();
+		unlink((dir + "/index.idx").c_str());
+		unlink((dir + "/index.heap").c_str());
+		rmdir(dir.c_str());
+	}
+	bool insert(int key, int) { return table->insert(key, nameOf(key), emailOf(nameOf(key))); }
+	bool find(int key) { return table->search(key, found); }
+	bool remove(int key) { return table->remove(key); }
+	void histogram(const vector<int>&) {
+		cout << "  " << table->buckets() << " bucket pages, " << table->pages() - table->buckets() - 1 << " overflow pages" << endl;
+	}
+
+	static string makeTempDir() {
+		char dir[] = "/tmp/hash-bench-XXXXXX";
+		if (mkdtemp(dir) == NULL) {
+			cerr << "cannot create a temporary directory for the disk index" << endl;
+			exit(1);
+		}
+		return dir;
+	}
+};
+
+unsigned int DiskById::expectedRecords = 1 << 16;
+
+struct ChainingByName {
+	static const char* name() { return "chaining"; }
+	HashTable<string, Record> table;
+	bool insert(const string& key, int id) { return table.emplace(key, id, key, emailOf(key)); }
+	bool find(const string& key) { return table.search(key) != NULL; }
+	bool remove(const string& key) { return table.remove(key); }
+	void histogram(const vector<string>& keys) {
+		printBucketHistogram("  chains", bucketHistogram(keys, WyHash(), table.capacity()));
+	}
+};
+
+struct RobinHoodByName {
+	static const char* name() { return "robin-hood"; }
+	RobinHoodHashTable<> table;
+	bool insert(const string& key, int id) { return table.insert(id, key, emailOf(key)); }
+	bool find(const string& key) { return table.search(key) != NULL; }
+	bool remove(const string& key) { return table.remove(key); }
+	void histogram(const vector<string>&) {
+		RobinHoodHashTable<>::ProbeStats stats = table.probeStats();
+		cout << "  probe lengths: max " << stats.maxProbeLength << ", mean " << stats.meanProbeLength << endl;
+		for (unsigned int d = 0; d < stats.histogram.size(); d++)
+			if (stats.histogram[d] > 0) cout << "  probe length " << d << ": " << stats.histogram[d] << " items" << endl;
+	}
+};
+
+struct SwissByName {
+	static const char* name() { return "swiss"; }
+	SwissHashTable<> table;
+	bool insert(const string& key, int id) { return table.insert(id, key, emailOf(key)); }
+	bool find(const string& key) { return table.search(key) != NULL; }
+	bool remove(const string& key) { return table.remove(key); }
+	void histogram(const vector<string>&) {}
+};
+
+struct BloomByName {
+	static const char* name() { return "bloom-chaining"; }
+	BloomFilteredHashTable<string, Record> table;
+	bool insert(const string& key, int id) { return table.emplace(key, id, key, emailOf(key)); }
+	bool find(const string& key) { return table.search(key) != NULL; }
+	bool remove(const string& key) { return table.remove(key); }
+	void histogram(const vector<string>& keys) {
+		printBucketHistogram("  chains", bucketHistogram(keys, WyHash(), table.table().capacity()));
+	}
+};
+
+struct StoreByName {
+	static const char* name() { return "record-store"; }
+	RecordStore<> store;
+	bool insert(const string& key, int id) { return store.insert(id, key, emailOf(key)); }
+	bool find(const string& key) { return store.findByName(key) != NULL; }
+	bool remove(const string& key) { return store.removeByName(key); }
+	void histogram(const vector<string>&) {}
+};
+
+// ---- measurement
+
+struct Options {
+	int keys = 200000;
+	int ops = 1000000;
+	string workload = "all";
+	string mix = "all";
+	string table = "all";
+	bool histograms = false;
+};
+
+static size_t heapInUse() {
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+template <class Table, class Key>
+void build(Table& table, const vector<Key>& pool, int keys) {
+	for (int i = 0; i < keys; i++) table.insert(pool[i], i);
+}
+
+template <class Table, class Key>
+long long apply(Table& table, const vector<Key>& pool, const Op& op) {
+	switch (op.type) {
+	case SEARCH: return table.find(pool[op.key]);
+	case INSERT: return table.insert(pool[op.key], op.key);
+	default: return table.remove(pool[op.key]);
+	}
+}
+
+template <class Table, class Key>
+void run(const Options& options, const Workload& w, const Mix& mix, const vector<Key>& pool, const vector<Op>& ops) {
+	if (options.table != "all" && options.table != Table::name()) return;
+
+	// pass 1: bytes per entry and throughput
+	size_t before = heapInUse();
+	Table* table = new Table();
+	build(*table, pool, options.keys);
+	double bytesPerEntry = (double)(heapInUse() - before) / options.keys;
+	if (options.histograms) {
+		cout << Table::name() << " after " << options.keys << " inserts:" << endl;
+		table->histogram(vector<Key>(pool.begin(), pool.begin() + options.keys));
+	}
+
+	long long checksum = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (const Op& op : ops) checksum += apply(*table, pool, op);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	delete table;
+
+	// pass 2: latency of every operation
+	table = new Table();
+	build(*table, pool, options.keys);
+	vector<uint32_t> latencies(ops.size());
+	for (size_t i = 0; i < ops.size(); i++) {
+		chrono::steady_clock::time_point opStart = chrono::steady_clock::now();
+		checksum -= apply(*table, pool, ops[i]);
+		latencies[i] = (uint32_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - opStart).count();
+	}
+	delete table;
+	sort(latencies.begin(), latencies.end());
+
+	// both passes ran the same operations, so the results must match
+	cout << setw(11) << w.name << setw(7) << mix.name << setw(16) << Table::name() << fixed << setprecision(2)
+	     << setw(10) << ops.size() / seconds / 1e6
+	     << setw(8) << latencies[latencies.size() / 2]
+	     << setw(8) << latencies[latencies.size() * 99 / 100]
+	     << setw(8) << latencies[latencies.size() * 999 / 1000]
+	     << setw(10) << setprecision(1) << bytesPerEntry
+	     << (checksum == 0 ? "" : "  (passes disagree!)") << endl;
+}
+
+Options parse(int argc, char* argv[]) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		size_t eq = arg.find('=');
+		string key = arg.substr(0, eq);
+		string value = eq == string::npos ? "" : arg.substr(eq + 1);
+		if (key == "keys") options.keys = atoi(value.c_str());
+		else if (key == "ops") options.ops = atoi(value.c_str());
+		else if (key == "workload") options.workload = value;
+		else if (key == "mix") options.mix = value;
+		else if (key == "table") options.table = value;
+		else if (key == "histograms") options.histograms = value != "0";
+		else {
+			cerr << "unknown option " << arg << endl;
+			exit(1);
+		}
+	}
+	return options;
+}
+
+
+int main(int argc, char* argv[])
+{
+	Options options = parse(argc, argv);
+
+	const char* workloads[] = {"uniform", "zipfian", "sequential", "stepped", "names", "anagrams"};
+	const Mix mixes[] = {
+		{"read", 100, 0, false},
+		{"miss", 100, 0, true},
+		{"mixed", 90, 5, false},
+		{"write", 50, 25, false},
+	};
+
+	DiskById::expectedRecords = options.keys + options.ops / 2;
+
+	cout << options.keys << " keys, " << options.ops << " operations per run" << endl;
+	cout << setw(11) << "workload" << setw(7) << "mix" << setw(16) << "table" << setw(10) << "Mops/s"
+	     << setw(8) << "p50" << setw(8) << "p99" << setw(8) << "p999" << setw(10) << "B/entry" << endl;
+
+	for (const char* name : workloads) {
+		if (options.workload != "all" && options.workload != name) continue;
+		// room for every insert of the sequence, plus keys that are never inserted for misses
+		Workload w = makeWorkload(name, options.keys, options.ops / 2 + options.keys);
+
+		for (const Mix& mix : mixes) {
+			if (options.mix != "all" && options.mix != mix.name) continue;
+			vector<Op> ops = makeOps(w, mix, options.keys, options.ops);
+
+			if (w.stringKeys) {
+				run<ChainingByName>(options, w, mix, w.names, ops);
+				run<BloomByName>(options, w, mix, w.names, ops);
+				run<RobinHoodByName>(options, w, mix, w.names, ops);
+				run<SwissByName>(options, w, mix, w.names, ops);
+				run<StoreByName>(options, w, mix, w.names, ops);
+			} else {
+				run<ChainingById>(options, w, mix, w.ids, ops);
+				run<CuckooById>(options, w, mix, w.ids, ops);
+				run<ConcurrentById>(options, w, mix, w.ids, ops);
+				run<StoreById>(options, w, mix, w.ids, ops);
+				run<DiskById>(options, w, mix, w.ids, ops);
+			}
+		}
+	}
+	cout << "latencies in ns" << endl;
+
+	return 0;
+}
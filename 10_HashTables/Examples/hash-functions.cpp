@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "hash-functions.h"
+using namespace std;
+
+// Compares how the original example hash and WyHash spread typical key sets
+// over the 2000 buckets the examples started with.
+
+const int BUCKETS = 2000;
+
+template <class Key>
+void compare(const string& title, const vector<Key>& keys) {
+	cout<< "== " << title << endl;
+	printBucketHistogram("legacy", bucketHistogram(keys, LegacyHash(), BUCKETS));
+	printBucketHistogram("wyhash", bucketHistogram(keys, WyHash(), BUCKETS));
+	printBucketHistogram("wyhash, random seed", bucketHistogram(keys, WyHash(hashing::randomSeed()), BUCKETS));
+	cout<< endl;
+}
+
+
+int main()
+{
+	// ID numbers handed out in blocks per faculty: 1000101, 1001101, 1002101, ...
+	vector<int> blockIds;
+	for (int faculty = 1; faculty <= 5; faculty++)
+		for (int i = 0; i < 1000; i++) blockIds.push_back(faculty * 1000000 + i * 1000 + 101);
+	compare("ID numbers in steps of 1000", blockIds);
+
+	// short names: "user0" .. "user4999"
+	vector<string> names;
+	for (int i = 0; i < 5000; i++) names.push_back("user" + to_string(i));
+	compare("short generated names", names);
+
+	// every anagram of "andrew" sums to the same value
+	vector<string> anagrams;
+	string letters = "adenrw";
+	do anagrams.push_back(letters); while (next_permutation(letters.begin(), letters.end()));
+	compare("anagrams of andrew", anagrams);
+
+    return 0;
+}
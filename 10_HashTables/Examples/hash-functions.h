@@ -0,0 +1,188 @@
+#ifndef HASH_TABLES_HASH_FUNCTIONS_H
+#define HASH_TABLES_HASH_FUNCTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hasher policies for the example tables.
+//
+// A hasher is any copyable type with
+//     uint64_t operator()(std::string_view) const
+//     uint64_t operator()(int) const
+// Taking std::string_view lets std::string, string literals and views all
+// hash without copying, which is what is_transparent advertises to the tables.
+// The tables take it as a template parameter and reduce the 64-bit result to
+// a bucket index themselves, so the same hasher works for every capacity.
+
+namespace hashing {
+
+// 128-bit multiply, folding the high and low halves together
+inline uint64_t mix128(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+inline uint64_t read8(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+inline uint64_t read4(const unsigned char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline uint64_t read3(const unsigned char* p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+// wyhash (final version 4). Reads the key 8 or 16 bytes at a time, so short
+// names hash in a handful of instructions, and every input bit affects every
+// output bit.
+inline uint64_t wyhash(const void* key, size_t len, uint64_t seed) {
+    static const uint64_t secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                       0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    seed ^= mix128(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix128(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                see1 = mix128(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                see2 = mix128(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix128(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    __uint128_t product = (__uint128_t)a * b;
+    a = (uint64_t)product;
+    b = (uint64_t)(product >> 64);
+    return mix128(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+// MurmurHash3 64-bit finalizer: consecutive integers land far apart
+inline uint64_t mixInteger(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+// A seed the caller cannot predict, so crafted keys cannot target one bucket.
+inline uint64_t randomSeed() {
+    std::random_device device;
+    return ((uint64_t)device() << 32) ^ device();
+}
+
+}  // namespace hashing
+
+
+// Default hasher: wyhash for strings, Murmur3 finalizer for integers.
+// Pass hashing::randomSeed() when keys may come from an adversary.
+struct WyHash {
+    uint64_t seed;
+
+    typedef void is_transparent;
+
+    explicit WyHash(uint64_t s = 0) : seed(s) {}
+
+    uint64_t operator()(std::string_view str) const {
+        return hashing::wyhash(str.data(), str.size(), seed);
+    }
+
+    uint64_t operator()(int key) const {
+        return hashing::mixInteger((uint64_t)(uint32_t)key + seed);
+    }
+};
+
+// The original example hash: sum of character codes for strings and the key
+// itself for integers. Kept only to compare against in the diagnostics.
+struct LegacyHash {
+    typedef void is_transparent;
+
+    uint64_t operator()(std::string_view str) const {
+        uint64_t sum = 0;
+        for (unsigned char c : str) sum += c;
+        return sum;
+    }
+
+    uint64_t operator()(int key) const {
+        return (uint64_t)(uint32_t)key;
+    }
+};
+
+
+// Diagnostics: how a hasher spreads a key set over a fixed number of buckets.
+struct BucketHistogram {
+    unsigned int buckets;
+    unsigned int keys;
+    unsigned int usedBuckets;
+    unsigned int maxChainLength;
+    // chainLengths[n] = number of buckets that hold exactly n keys
+    std::vector<unsigned int> chainLengths;
+
+    // mean chain length a successful lookup walks (1 is perfect)
+    double meanLookupLength() const {
+        unsigned long long total = 0;
+        for (unsigned int n = 0; n < chainLengths.size(); ++n)
+            total += (unsigned long long)chainLengths[n] * n * (n + 1) / 2;
+        return keys == 0 ? 0.0 : (double)total / keys;
+    }
+};
+
+template <class Key, class Hasher>
+BucketHistogram bucketHistogram(const std::vector<Key>& keys, const Hasher& hasher, unsigned int buckets) {
+    std::vector<unsigned int> occupancy(buckets, 0);
+    for (const Key& key : keys) occupancy[hasher(key) % buckets]++;
+
+    BucketHistogram histogram;
+    histogram.buckets = buckets;
+    histogram.keys = keys.size();
+    histogram.usedBuckets = 0;
+    histogram.maxChainLength = 0;
+    for (unsigned int count : occupancy) {
+        if (count >= histogram.chainLengths.size()) histogram.chainLengths.resize(count + 1, 0);
+        histogram.chainLengths[count]++;
+        if (count > 0) histogram.usedBuckets++;
+        if (count > histogram.maxChainLength) histogram.maxChainLength = count;
+    }
+    return histogram;
+}
+
+inline void printBucketHistogram(const std::string& title, const BucketHistogram& histogram) {
+    std::cout << title << ": " << histogram.keys << " keys in " << histogram.usedBuckets << " of "
+              << histogram.buckets << " buckets, longest chain " << histogram.maxChainLength
+              << ", mean lookup length " << histogram.meanLookupLength() << std::endl;
+    for (unsigned int n = 0; n < histogram.chainLengths.size(); ++n) {
+        if (histogram.chainLengths[n] == 0) continue;
+        std::cout << "  chain length " << n << ": " << histogram.chainLengths[n] << " buckets" << std::endl;
+    }
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "hash-join.h"
+#include "hash-table.h"
+#include "record.h"
+using namespace std;
+
+// Joins the member records with a feed of payments on idNumber.
+// See hash-join.h.
+//
+// usage: hash-join [members] [payments]
+
+struct Payment {
+	int idNumber;
+	int cents;
+};
+
+struct MemberId {
+	int operator()(const Record& record) const { return record.idNumber; }
+};
+
+struct PaymentId {
+	int operator()(const Payment& payment) const { return payment.idNumber; }
+};
+
+typedef HashJoin<Record, Payment, MemberId, PaymentId> MemberPayments;
+
+struct JoinResult {
+	double seconds;
+	size_t matches;
+	long long cents;
+};
+
+// the way it is done today: a HashTable on the members, searched once per payment
+static JoinResult searchJoin(const vector<Record>& members, const vector<Payment>& payments) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	HashTable<int, const Record*> byId;
+	for (const Record& member : members) byId.insert(member.idNumber, &member);
+	JoinResult result = {0, 0, 0};
+	for (const Payment& payment : payments) {
+		const Record** member = byId.search(payment.idNumber);
+		if (member != NULL) {
+			result.matches++;
+			result.cents += payment.cents + (*member)->idName.size();
+		}
+	}
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+static JoinResult hashJoin(const vector<Record>& members, const vector<Payment>& payments, JoinMethod method,
+                           size_t& partitions) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	MemberPayments join(members, payments, MemberId(), PaymentId(), method);
+	JoinResult result = {0, 0, 0};
+	result.matches = join.forEach([&result](const Record& member, const Payment& payment) {
+		result.cents += payment.cents + member.idName.size();
+	});
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	partitions = join.partitions();
+	return result;
+}
+
+static void report(const string& name, const JoinResult& result, size_t rows) {
+	cout<< "  " << name << result.seconds * 1000 << " ms, " << rows / result.seconds / 1e6 << " M rows/s, "
+	    << result.matches << " matches, checksum " << result.cents << endl;
+}
+
+
+int main(int argc, char* argv[])
+{
+	vector<Record> members;
+	members.push_back(Record(1000101, "jacob",  "jacob23@uw.ca"));
+	members.push_back(Record(2001201, "shawn",  "shawn3@uw.ca"));
+	members.push_back(Record(3003121, "max",  "maxmax@uw.ca"));
+	members.push_back(Record(3004578, "grace",  "grace2@uw.ca"));
+	members.push_back(Record(2001234, "andrew",  "andrew@uw.ca"));
+	members.push_back(Record(5201863, "peter",  "peterw2@uw.ca"));
+	members.push_back(Record(3005831, "emily",  "emily3@uw.ca"));
+
+	vector<Payment> payments = {{3004578, 2500}, {1000101, 1200}, {9999999, 700}, {3004578, 4000}};
+
+	// the payments are the smaller side here, so they are built and the
+	// members probe: matches come out in member order
+	MemberPayments join(members, payments);
+	for (MemberPayments::iterator it = join.begin(); it != join.end(); ++it)
+		cout<< it->left->idName << " paid " << it->right->cents / 100.0 << endl;
+
+	// the benchmark: a million members, ten million payments, one in ten for an unknown id
+	size_t memberCount = argc > 1 ? atoi(argv[1]) : 1000000;
+	size_t paymentCount = argc > 2 ? atoi(argv[2]) : 10000000;
+	mt19937 random(42);
+
+	members.clear();
+	for (size_t i = 0; i < memberCount; i++) {
+		int id = (int)((i * 2654435761u) & 0x7FFFFFFF);    // distinct, in no particular order
+		string name = "member" + to_string(id);
+		members.push_back(Record(id, name, name + "@uw.ca"));
+	}
+	payments.resize(paymentCount);
+	for (Payment& payment : payments) {
+		size_t pick = random() % (memberCount + memberCount / 9);
+		payment.idNumber = pick < memberCount ? members[pick].idNumber : -(int)pick;
+		payment.cents = (int)(random() % 10000);
+	}
+
+	size_t partitions;
+	cout << endl << memberCount << " members joined with " << paymentCount << " payments" << endl;
+	report("HashTable search:     ", searchJoin(members, payments), memberCount + paymentCount);
+	JoinResult direct = hashJoin(members, payments, JoinMethod::DIRECT, partitions);
+	report("hash join:            ", direct, memberCount + paymentCount);
+	JoinResult partitioned = hashJoin(members, payments, JoinMethod::PARTITIONED, partitions);
+	report("partitioned (" + to_string(partitions) + "):    ", partitioned, memberCount + paymentCount);
+	if (direct.matches != partitioned.matches || direct.cents != partitioned.cents)
+		cout << "the two joins disagree" << endl;
+
+	return 0;
+}
@@ -0,0 +1,302 @@
+#ifndef HASH_TABLES_HASH_JOIN_H
+#define HASH_TABLES_HASH_JOIN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "hash-functions.h"
+
+// How HashJoin lays out its work.
+//
+// DIRECT builds one table over the whole smaller side and probes it with the
+// larger side in input order. PARTITIONED first splits both sides into
+// partitions by the top bits of the key hash, so that each partition's table
+// fits in the L2 cache, and then joins partition by partition. That costs an
+// extra pass over both sides, which only pays off once a single table would
+// no longer stay in the last level cache, so AUTO partitions above 16 MiB of
+// table (about a million build rows).
+enum class JoinMethod { AUTO, DIRECT, PARTITIONED };
+
+// Equi-join of two row arrays on an int key, e.g. records on idNumber.
+//
+// The smaller side is the build side: its keys and row numbers go into a
+// compact open-addressing table of 8-byte {key, row} entries with linear
+// probing, kept at most half full. The larger side is the probe side. Its
+// keys are hashed BATCH at a time and their slots prefetched before any is
+// compared, so the cache misses of a batch overlap. Keys may repeat on
+// either side; every pair of rows with equal keys is a match.
+//
+// Matches are produced on demand, CHUNK at a time, through next(), forEach()
+// or an input iterator. The join never holds more than one chunk of output,
+// so joining 10M rows to 1M does not materialize the result. A partitioned
+// join also keeps a {key, row} copy of both sides, 8 bytes per row.
+//
+// Rows are referenced, not copied: both arrays must outlive the join.
+// LeftKey and RightKey map a row to its int key.
+template <class Left, class Right, class LeftKey, class RightKey, class Hasher = WyHash>
+class HashJoin {
+public:
+    static const size_t BATCH = 16;
+    static const size_t CHUNK = 1024;
+    // AUTO partitions when one table would be larger than this
+    static const size_t DIRECT_TABLE_BYTES = 16 << 20;
+    // each partition's table aims for this size
+    static const size_t PARTITION_TABLE_BYTES = 256 * 1024;
+    static const unsigned int MAX_PARTITION_BITS = 10;
+
+    struct Match {
+        const Left* left;
+        const Right* right;
+    };
+
+    HashJoin(const Left* left, size_t leftCount, const Right* right, size_t rightCount,
+             const LeftKey& leftKey = LeftKey(), const RightKey& rightKey = RightKey(),
+             JoinMethod method = JoinMethod::AUTO, const Hasher& hasher = Hasher())
+        : left_(left), right_(right), leftKey_(leftKey), rightKey_(rightKey), hasher_(hasher),
+          buildLeft_(leftCount <= rightCount), partitionBits_(0), partition_(0),
+          probePos_(0), probeEnd_(0), groupPos_(0), groupSize_(0), slot_(0), outPos_(0) {
+        if (leftCount >= EMPTY || rightCount >= EMPTY) throw std::length_error("HashJoin: too many rows");
+        buildCount_ = buildLeft_ ? leftCount : rightCount;
+        probeCount_ = buildLeft_ ? rightCount : leftCount;
+
+        size_t tableBytes = tableCapacity(buildCount_) * sizeof(Entry);
+        if (method == JoinMethod::PARTITIONED
+            || (method == JoinMethod::AUTO && tableBytes > DIRECT_TABLE_BYTES)) {
+            while (partitionBits_ < MAX_PARTITION_BITS && (tableBytes >> partitionBits_) > PARTITION_TABLE_BYTES)
+                partitionBits_++;
+            if (partitionBits_ == 0) partitionBits_ = 1;
+        }
+        partitionSides();
+        partition_ = ~(size_t)0;    // the first loadGroup starts partition 0
+    }
+
+    HashJoin(const std::vector<Left>& left, const std::vector<Right>& right,
+             const LeftKey& leftKey = LeftKey(), const RightKey& rightKey = RightKey(),
+             JoinMethod method = JoinMethod::AUTO, const Hasher& hasher = Hasher())
+        : HashJoin(left.data(), left.size(), right.data(), right.size(), leftKey, rightKey, method, hasher) {}
+
+    HashJoin(const HashJoin&) = delete;
+    HashJoin& operator=(const HashJoin&) = delete;
+
+    // The next match, or false once every match has been produced.
+    bool next(Match& match) {
+        if (outPos_ == out_.size()) {
+            refill();
+            if (out_.empty()) return false;
+        }
+        const Pair& pair = out_[outPos_++];
+        if (buildLeft_) {
+            match.left = left_ + pair.build;
+            match.right = right_ + pair.probe;
+        } else {
+            match.left = left_ + pair.probe;
+            match.right = right_ + pair.build;
+        }
+        return true;
+    }
+
+    // Calls emit(const Left&, const Right&) for every remaining match.
+    // Returns how many there were.
+    template <class Emit>
+    size_t forEach(Emit&& emit) {
+        size_t count = 0;
+        Match match;
+        while (next(match)) {
+            emit(*match.left, *match.right);
+            count++;
+        }
+        return count;
+    }
+
+    size_t partitions() const { return (size_t)1 << partitionBits_; }
+    bool partitioned() const { return partitionBits_ > 0; }
+    bool buildsLeft() const { return buildLeft_; }
+
+    // Single-pass input iterator over the remaining matches.
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Match value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Match* pointer;
+        typedef const Match& reference;
+
+        iterator() : join_(nullptr), match_() {}
+        explicit iterator(HashJoin* join) : join_(join), match_() { ++*this; }
+
+        const Match& operator*() const { return match_; }
+        const Match* operator->() const { return &match_; }
+
+        iterator& operator++() {
+            if (!join_->next(match_)) join_ = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return join_ == other.join_; }
+        bool operator!=(const iterator& other) const { return join_ != other.join_; }
+
+    private:
+        HashJoin* join_;
+        Match match_;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    static const uint32_t EMPTY = ~(uint32_t)0;
+
+    struct Entry {
+        int32_t key;
+        uint32_t row;    // EMPTY marks a free slot
+    };
+
+    struct Pair {
+        uint32_t build;
+        uint32_t probe;
+    };
+
+    // a power of two at least twice the rows, so runs stay short
+    static size_t tableCapacity(size_t rows) {
+        size_t capacity = 16;
+        while (capacity < rows * 2) capacity *= 2;
+        return capacity;
+    }
+
+    uint64_t hashOf(int key) const { return hasher_(key); }
+
+    int buildKey(size_t row) const { return buildLeft_ ? leftKey_(left_[row]) : rightKey_(right_[row]); }
+    int probeKey(size_t row) const { return buildLeft_ ? rightKey_(right_[row]) : leftKey_(left_[row]); }
+
+    size_t partitionOf(uint64_t hash) const {
+        return partitionBits_ == 0 ? 0 : (size_t)(hash >> (64 - partitionBits_));
+    }
+
+    // Copies {key, row} of each side into one array per side, grouped by
+    // partition: a histogram, then a scatter into the counted ranges. An
+    // unpartitioned join only copies the build side.
+    void partitionSides() {
+        scatter(buildCount_, true, buildPairs_, buildStart_);
+        if (partitioned()) scatter(probeCount_, false, probePairs_, probeStart_);
+    }
+
+    void scatter(size_t rows, bool build, std::vector<Entry>& pairs, std::vector<size_t>& start) {
+        start.assign(partitions() + 1, 0);
+        for (size_t row = 0; row < rows; ++row) {
+            int key = build ? buildKey(row) : probeKey(row);
+            start[partitionOf(hashOf(key)) + 1]++;
+        }
+        for (size_t p = 0; p < partitions(); ++p) start[p + 1] += start[p];
+
+        pairs.resize(rows);
+        std::vector<size_t> fill(start.begin(), start.end() - 1);
+        for (size_t row = 0; row < rows; ++row) {
+            int key = build ? buildKey(row) : probeKey(row);
+            Entry& entry = pairs[fill[partitionOf(hashOf(key))]++];
+            entry.key = key;
+            entry.row = (uint32_t)row;
+        }
+    }
+
+    // builds the table for partition p and points the probe range at it
+    void startPartition(size_t p) {
+        size_t first = buildStart_[p], last = buildStart_[p + 1];
+        size_t capacity = tableCapacity(last - first);
+        Entry empty = {0, EMPTY};
+        table_.assign(capacity, empty);
+        mask_ = capacity - 1;
+        for (size_t i = first; i < last; ++i) {
+            size_t slot = hashOf(buildPairs_[i].key) & mask_;
+            while (table_[slot].row != EMPTY) slot = (slot + 1) & mask_;
+            table_[slot] = buildPairs_[i];
+        }
+
+        partition_ = p;
+        probePos_ = partitioned() ? probeStart_[p] : 0;
+        probeEnd_ = partitioned() ? probeStart_[p + 1] : probeCount_;
+    }
+
+    // hashes the next BATCH probe keys and prefetches their slots, moving on
+    // to the next partition when this one is used up
+    bool loadGroup() {
+        while (probePos_ == probeEnd_) {
+            if (partition_ + 1 >= partitions()) return false;
+            startPartition(partition_ + 1);
+        }
+        groupSize_ = probeEnd_ - probePos_ < BATCH ? probeEnd_ - probePos_ : BATCH;
+        for (size_t i = 0; i < groupSize_; ++i, ++probePos_) {
+            if (partitioned()) {
+                groupKeys_[i] = probePairs_[probePos_].key;
+                groupRows_[i] = probePairs_[probePos_].row;
+            } else {
+                groupKeys_[i] = probeKey(probePos_);
+                groupRows_[i] = (uint32_t)probePos_;
+            }
+            groupSlots_[i] = hashOf(groupKeys_[i]) & mask_;
+            __builtin_prefetch(&table_[groupSlots_[i]]);
+        }
+        groupPos_ = 0;
+        slot_ = groupSlots_[0];
+        return true;
+    }
+
+    // Produces up to CHUNK matches. A run of equal keys may be cut off by a
+    // full chunk; the next refill resumes at the slot where it stopped.
+    void refill() {
+        out_.clear();
+        outPos_ = 0;
+        while (out_.size() < CHUNK) {
+            if (groupPos_ == groupSize_ && !loadGroup()) return;
+
+            int key = groupKeys_[groupPos_];
+            size_t slot = slot_;
+            while (table_[slot].row != EMPTY) {
+                if (table_[slot].key == key) {
+                    Pair pair = {table_[slot].row, groupRows_[groupPos_]};
+                    out_.push_back(pair);
+                    if (out_.size() == CHUNK) {
+                        slot_ = (slot + 1) & mask_;
+                        return;
+                    }
+                }
+                slot = (slot + 1) & mask_;
+            }
+            if (++groupPos_ < groupSize_) slot_ = groupSlots_[groupPos_];
+        }
+    }
+
+    const Left* left_;
+    const Right* right_;
+    LeftKey leftKey_;
+    RightKey rightKey_;
+    Hasher hasher_;
+    bool buildLeft_;
+    size_t buildCount_;
+    size_t probeCount_;
+
+    unsigned int partitionBits_;
+    std::vector<Entry> buildPairs_;     // build side grouped by partition
+    std::vector<size_t> buildStart_;    // first pair of each partition, plus the end
+    std::vector<Entry> probePairs_;     // probe side grouped by partition, if partitioned
+    std::vector<size_t> probeStart_;
+
+    std::vector<Entry> table_;    // the current partition's table
+    size_t mask_;
+    size_t partition_;
+    size_t probePos_;             // next probe row (or pair) to load
+    size_t probeEnd_;
+
+    int groupKeys_[BATCH];
+    uint32_t groupRows_[BATCH];
+    size_t groupSlots_[BATCH];
+    size_t groupPos_;             // the probe key being matched
+    size_t groupSize_;
+    size_t slot_;                 // where its run continues
+
+    std::vector<Pair> out_;
+    size_t outPos_;
+};
+
+#endif
@@ -0,0 +1,431 @@
+#ifndef HASH_TABLES_HASH_TABLE_H
+#define HASH_TABLES_HASH_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "slab-allocator.h"
+
+// Separate chaining hash table, generic over key, value, hasher and equality.
+//
+// Every item is one node holding the key and value, linked into the chain of
+// its bucket. Nodes are constructed in place by emplace, so records are never
+// copied on the way in. Node memory comes from a per-table NodeSlab rather
+// than one heap allocation per item, and removed nodes are reused by later
+// inserts.
+//
+// The table also owns a StringArena. intern copies a string into it and
+// returns a view that stays valid until clear() or the table is destroyed, so
+// records can hold std::string_view fields instead of std::strings with their
+// own heap buffers. With trivially destructible keys and values, clear() and
+// the destructor never walk the chains: they just drop whole slabs.
+//
+// If both Hasher and KeyEqual declare is_transparent (WyHash and
+// std::equal_to<> do), lookups accept any type the two can handle, e.g. a
+// std::string_view or string literal for a std::string key, without building
+// a temporary Key. Otherwise lookup keys are converted to Key first.
+//
+// The table doubles when it is 75% full and halves when it drops below 20%,
+// with the rehash spread over the following operations (see rehashStep). Each
+// step moves enough old buckets that a resize finishes before the next one
+// could be due, and the load is checked again when it does.
+template <class Key, class Value, class Hasher = WyHash, class KeyEqual = std::equal_to<>>
+class HashTable {
+public:
+    static const size_t MIN_CAPACITY = 16;
+    // old buckets moved to the new array by every insert, search and remove while growing
+    static const size_t MIGRATE_BUCKETS = 4;
+    // the same while shrinking. a shrink from C buckets starts at C/5 items and
+    // the next one is due at C/10, so the C old buckets have to be moved in
+    // fewer than C/10 removes: more than 10 a step. most of them are empty.
+    static const size_t SHRINK_MIGRATE_BUCKETS = 16;
+    // keys whose cache misses searchBatch overlaps
+    static const size_t BATCH_GROUP = 16;
+
+    struct Node {
+        Node* next;
+        Key key;
+        Value value;
+
+        template <class K, class... Args>
+        Node(K&& k, Args&&... args)
+            : next(nullptr), key(std::forward<K>(k)), value(std::forward<Args>(args)...) {}
+    };
+
+    explicit HashTable(const Hasher& hasher = Hasher(), const KeyEqual& equal = KeyEqual())
+        : hasher_(hasher), equal_(equal), table_(nullptr), capacity_(MIN_CAPACITY), size_(0),
+          oldTable_(nullptr), oldCapacity_(0), migrateIndex_(0), migrateStep_(MIGRATE_BUCKETS) {
+        table_ = allocateBuckets(capacity_);
+    }
+
+    ~HashTable() {
+        destroyNodes();
+        std::free(table_);
+        std::free(oldTable_);
+    }
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // Removes every item and returns all node slabs and string blocks at once.
+    // Views returned by intern become invalid.
+    void clear() {
+        Node** buckets = allocateBuckets(MIN_CAPACITY);
+        destroyNodes();
+        std::free(table_);
+        std::free(oldTable_);
+        nodes_.release();
+        strings_.release();
+
+        table_ = buckets;
+        capacity_ = MIN_CAPACITY;
+        size_ = 0;
+        oldTable_ = nullptr;
+        oldCapacity_ = 0;
+        migrateIndex_ = 0;
+        migrateStep_ = MIGRATE_BUCKETS;
+    }
+
+    // Copies str into the table's string arena. The view stays valid until
+    // clear() or destruction; removing an item does not reclaim its strings.
+    std::string_view intern(std::string_view str) { return strings_.intern(str); }
+
+    // Bytes owned by the table: bucket arrays, node slabs and string blocks.
+    size_t memoryUsage() const {
+        return (capacity_ + oldCapacity_) * sizeof(Node*) + nodes_.memoryUsage() + strings_.memoryUsage();
+    }
+
+    // Returns the value stored under key, or nullptr.
+    template <class Q>
+    Value* search(const Q& key) {
+        rehashStep();
+        uint64_t hash = hasher_(lookupKey<Q>(key));
+        Node* node = findNode(lookupKey<Q>(key), hash);
+        return node == nullptr ? nullptr : &node->value;
+    }
+
+    template <class Q>
+    bool contains(const Q& key) {
+        return search(key) != nullptr;
+    }
+
+    // Looks up count keys at once: results[i] = search(keys[i]).
+    //
+    // Keys are resolved in groups of BATCH_GROUP, in three passes over the
+    // group: hash every key and prefetch its bucket; load every bucket head
+    // and prefetch the first node; then walk each chain to its end, one key
+    // after another. Only the bucket and first node are prefetched, which is
+    // all most chains have at this load factor. This pays off when a lookup
+    // is long enough that the CPU cannot overlap the misses of consecutive
+    // lookups by itself, e.g. for string keys. For int keys a plain loop of
+    // search() is as fast (see hash-tables.md).
+    //
+    // Keys must be Key itself unless lookups are heterogeneous.
+    template <class Q>
+    void searchBatch(const Q* keys, size_t count, Value** results) {
+        static_assert(HETEROGENEOUS || std::is_same<Q, Key>::value, "batch keys must be Key for this hasher");
+        for (size_t first = 0; first < count; first += BATCH_GROUP) {
+            size_t n = count - first < BATCH_GROUP ? count - first : BATCH_GROUP;
+            rehashStep();
+            if (oldTable_ != nullptr) {
+                // mid-resize a key may be in either array; rare enough to do one by one
+                for (size_t i = 0; i < n; ++i) {
+                    Node* node = findNode(keys[first + i], hasher_(keys[first + i]));
+                    results[first + i] = node == nullptr ? nullptr : &node->value;
+                }
+            } else {
+                searchGroup(keys + first, n, results + first);
+            }
+        }
+    }
+
+    template <class Q>
+    void searchBatch(const std::vector<Q>& keys, std::vector<Value*>& results) {
+        results.resize(keys.size());
+        searchBatch(keys.data(), keys.size(), results.data());
+    }
+
+    // Insert-or-get. If key exists, returns {its value, false} and constructs
+    // nothing. Otherwise constructs a node from key and Value(args...), links
+    // it at the head of its chain and returns {new value, true}.
+    // The key is hashed once and its chain walked once.
+    template <class K, class... Args>
+    std::pair<Value*, bool> try_emplace(K&& key, Args&&... args) {
+        rehashStep();
+        uint64_t hash = hasher_(lookupKey<K>(key));
+        Node* found = findNode(lookupKey<K>(key), hash);
+        if (found != nullptr) return std::make_pair(&found->value, false);
+
+        Node* node = createNode(std::forward<K>(key), std::forward<Args>(args)...);
+        linkNode(node, hash);
+        return std::make_pair(&node->value, true);
+    }
+
+    // Upsert: overwrites the value of an existing key, otherwise inserts it.
+    // The bool is true if a new item was inserted.
+    template <class K, class V>
+    std::pair<Value*, bool> insert_or_assign(K&& key, V&& value) {
+        rehashStep();
+        uint64_t hash = hasher_(lookupKey<K>(key));
+        Node* found = findNode(lookupKey<K>(key), hash);
+        if (found != nullptr) {
+            found->value = std::forward<V>(value);
+            return std::make_pair(&found->value, false);
+        }
+
+        Node* node = createNode(std::forward<K>(key), std::forward<V>(value));
+        linkNode(node, hash);
+        return std::make_pair(&node->value, true);
+    }
+
+    // Returns false, without constructing anything, if the key already exists.
+    template <class K, class... Args>
+    bool emplace(K&& key, Args&&... args) {
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+    }
+
+    bool insert(const Key& key, const Value& value) { return emplace(key, value); }
+    bool insert(Key&& key, Value&& value) { return emplace(std::move(key), std::move(value)); }
+
+    // Unlinks and frees the node in the same walk that finds it.
+    // Returns false if the key does not exist.
+    template <class Q>
+    bool remove(const Q& key) {
+        rehashStep();
+        uint64_t hash = hasher_(lookupKey<Q>(key));
+        if (!removeNode(lookupKey<Q>(key), hash)) return false;
+
+        size_--;
+        checkLoad();
+        return true;
+    }
+
+    // Calls visit(const Key&, Value&) for every item, in no particular order.
+    // visit must not insert into or remove from the table.
+    template <class Visitor>
+    void forEach(Visitor&& visit) {
+        visitBuckets(table_, capacity_, visit);
+        if (oldTable_ != nullptr) visitBuckets(oldTable_, oldCapacity_, visit);
+    }
+
+    // bucket of key in the current (newest) bucket array
+    template <class Q>
+    size_t hashFunction(const Q& key) const {
+        return bucketOf(lookupKey<Q>(key), capacity_);
+    }
+
+private:
+    template <class T, class = void>
+    struct IsTransparent : std::false_type {};
+    template <class T>
+    struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+    static const bool HETEROGENEOUS = IsTransparent<Hasher>::value && IsTransparent<KeyEqual>::value;
+
+    // the lookup key as-is for transparent hashers, otherwise converted to Key.
+    // a converted key is a temporary, so lookupKey is only ever called inside
+    // the full expression that uses its result.
+    template <class Q>
+    using LookupType = typename std::conditional<HETEROGENEOUS, Q, Key>::type;
+
+    template <class Q>
+    static const LookupType<typename std::decay<const Q>::type>& lookupKey(const LookupType<typename std::decay<const Q>::type>& key) {
+        return key;
+    }
+
+    // calloc hands back lazily zeroed pages for large arrays, so starting a
+    // resize does not touch every new bucket up front.
+    static Node** allocateBuckets(size_t cap) {
+        Node** buckets = static_cast<Node**>(std::calloc(cap, sizeof(Node*)));
+        if (buckets == nullptr) throw std::bad_alloc();
+        return buckets;
+    }
+
+    template <class... Args>
+    Node* createNode(Args&&... args) {
+        void* slot = nodes_.allocate();
+        try {
+            return new (slot) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            nodes_.deallocate(slot);
+            throw;
+        }
+    }
+
+    void destroyNode(Node* node) {
+        node->~Node();
+        nodes_.deallocate(node);
+    }
+
+    template <class Visitor>
+    static void visitBuckets(Node** buckets, size_t cap, Visitor& visit) {
+        for (size_t i = 0; i < cap; ++i) {
+            for (Node* node = buckets[i]; node != nullptr; node = node->next) visit(node->key, node->value);
+        }
+    }
+
+    // runs the destructors of all nodes; their memory goes back with the slabs
+    void destroyNodes() {
+        if (std::is_trivially_destructible<Node>::value) return;
+        destroyChains(table_, capacity_);
+        if (oldTable_ != nullptr) destroyChains(oldTable_, oldCapacity_);
+    }
+
+    static void destroyChains(Node** buckets, size_t cap) {
+        for (size_t i = 0; i < cap; ++i) {
+            Node* node = buckets[i];
+            while (node != nullptr) {
+                Node* next = node->next;
+                node->~Node();
+                node = next;
+            }
+        }
+    }
+
+    // capacities are powers of two, so the bucket is the low bits of the hash
+    template <class Q>
+    size_t bucketOf(const Q& key, size_t cap) const {
+        return (size_t)hasher_(key) & (cap - 1);
+    }
+
+    template <class Q>
+    Node* findInBuckets(Node** buckets, size_t cap, const Q& key, uint64_t hash) const {
+        Node* node = buckets[hash & (cap - 1)];
+        while (node != nullptr && !equal_(node->key, key)) node = node->next;
+        return node;
+    }
+
+    template <class Q>
+    Node* findNode(const Q& key, uint64_t hash) const {
+        Node* node = findInBuckets(table_, capacity_, key, hash);
+        if (node == nullptr && oldTable_ != nullptr) node = findInBuckets(oldTable_, oldCapacity_, key, hash);
+        return node;
+    }
+
+    // new items always go to the head of a chain in the newest array, in O(1)
+    void linkNode(Node* node, uint64_t hash) {
+        size_t bucket = hash & (capacity_ - 1);
+        node->next = table_[bucket];
+        table_[bucket] = node;
+
+        size_++;
+        checkLoad();
+    }
+
+    // starts a resize if the load is outside [20%, 75%] and none is running
+    void checkLoad() {
+        if (oldTable_ != nullptr) return;
+        if (size_ > capacity_ / 4 * 3) startResize(capacity_ * 2);
+        else if (capacity_ > MIN_CAPACITY && size_ < capacity_ / 5) startResize(capacity_ / 2);
+    }
+
+    // walks the chain through the links that point at each node, so the
+    // predecessor never has to be found again once the key is.
+    template <class Q>
+    bool removeFromBuckets(Node** buckets, size_t cap, const Q& key, uint64_t hash) {
+        Node** link = &buckets[hash & (cap - 1)];
+        while (*link != nullptr && !equal_((*link)->key, key)) link = &(*link)->next;
+        if (*link == nullptr) return false;
+
+        Node* node = *link;
+        *link = node->next;
+        destroyNode(node);
+        return true;
+    }
+
+    // one group of searchBatch, with no resize in progress
+    template <class Q>
+    void searchGroup(const Q* keys, size_t n, Value** results) {
+        Node** heads[BATCH_GROUP];
+        for (size_t i = 0; i < n; ++i) {
+            heads[i] = &table_[hasher_(keys[i]) & (capacity_ - 1)];
+            __builtin_prefetch(heads[i]);
+        }
+
+        Node* nodes[BATCH_GROUP];
+        for (size_t i = 0; i < n; ++i) {
+            nodes[i] = *heads[i];
+            if (nodes[i] != nullptr) __builtin_prefetch(nodes[i]);
+        }
+
+        // the heads are on their way, so walk each chain to the end in turn.
+        // most chains are one or two nodes long at this load factor.
+        for (size_t i = 0; i < n; ++i) {
+            Node* node = nodes[i];
+            while (node != nullptr && !equal_(node->key, keys[i])) node = node->next;
+            results[i] = node == nullptr ? nullptr : &node->value;
+        }
+    }
+
+    template <class Q>
+    bool removeNode(const Q& key, uint64_t hash) {
+        return removeFromBuckets(table_, capacity_, key, hash)
+            || (oldTable_ != nullptr && removeFromBuckets(oldTable_, oldCapacity_, key, hash));
+    }
+
+    // start moving every item into a new array of newCapacity buckets.
+    // the move itself is spread over the following operations by rehashStep.
+    void startResize(size_t newCapacity) {
+        oldTable_ = table_;
+        oldCapacity_ = capacity_;
+        migrateIndex_ = 0;
+        if (newCapacity < capacity_) migrateStep_ = SHRINK_MIGRATE_BUCKETS;
+        else migrateStep_ = MIGRATE_BUCKETS;
+        table_ = allocateBuckets(newCapacity);
+        capacity_ = newCapacity;
+    }
+
+    // moves up to migrateStep_ old buckets into the new array. nodes are relinked, not copied.
+    // once the last one is moved, the load may already call for the next resize.
+    void rehashStep() {
+        if (oldTable_ == nullptr) return;
+
+        for (size_t moved = 0; moved < migrateStep_ && migrateIndex_ < oldCapacity_; ++moved, ++migrateIndex_) {
+            Node* node = oldTable_[migrateIndex_];
+            while (node != nullptr) {
+                Node* next = node->next;
+                size_t bucket = bucketOf(node->key, capacity_);
+                node->next = table_[bucket];
+                table_[bucket] = node;
+                node = next;
+            }
+            oldTable_[migrateIndex_] = nullptr;
+        }
+
+        if (migrateIndex_ == oldCapacity_) {
+            std::free(oldTable_);
+            oldTable_ = nullptr;
+            oldCapacity_ = 0;
+            checkLoad();
+        }
+    }
+
+    Hasher hasher_;
+    KeyEqual equal_;
+
+    NodeSlab<Node> nodes_;
+    StringArena strings_;
+
+    Node** table_;      // array of chain heads
+    size_t capacity_;   // number of buckets in table_, a power of two
+    size_t size_;       // number of items in both arrays
+
+    // while a resize is in progress the items are split between two arrays.
+    // buckets of oldTable_ below migrateIndex_ have already been moved into table_.
+    Node** oldTable_;
+    size_t oldCapacity_;
+    size_t migrateIndex_;
+    size_t migrateStep_;    // old buckets moved per operation
+};
+
+#endif
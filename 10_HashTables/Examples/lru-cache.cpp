@@ -0,0 +1,90 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "lru-cache.h"
+#include "record.h"
+using namespace std;
+
+// A bounded cache of records keyed on idNumber, in front of a slow source.
+// See lru-cache.h.
+
+// stands in for a database or a file: builds the record from scratch every time
+static Record loadRecord(int idNumber) {
+	string name = "member" + to_string(idNumber);
+	return Record(idNumber, name, name + "@uw.ca");
+}
+
+// Zipf(s) over ranks [0, n): a few members are looked up far more than the rest
+static vector<int> zipfianIds(int n, double s, int count) {
+	vector<double> cdf(n);
+	double sum = 0;
+	for (int i = 0; i < n; i++) cdf[i] = (sum += 1.0 / pow(i + 1, s));
+	mt19937 random(42);
+	uniform_real_distribution<double> uniform(0, sum);
+	vector<int> ids(count);
+	for (int& id : ids) id = (int)(lower_bound(cdf.begin(), cdf.end(), uniform(random)) - cdf.begin());
+	return ids;
+}
+
+// runs the id stream through a cache of the given size; returns millions of lookups per second
+template <class Cache>
+double readThrough(Cache& cache, const vector<int>& ids) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	size_t checksum = 0;
+	for (int id : ids) checksum += cache.fetch(id, loadRecord).idName.size();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	if (checksum == 0) cout << "empty names?" << endl;
+	return ids.size() / seconds / 1e6;
+}
+
+
+int main()
+{
+	LruCache<int, Record> h(3);
+
+	h.put(1000101, 1000101, "jacob",  "jacob23@uw.ca");
+	h.put(2001201, 2001201, "shawn",  "shawn3@uw.ca");
+	h.put(3003121, 3003121, "max",  "maxmax@uw.ca");
+	h.get(1000101);                                    // jacob is now the most recently used
+	h.put(3004578, 3004578, "grace",  "grace2@uw.ca"); // full: evicts shawn
+
+	if ( h.get(2001201) == NULL )
+		cout << "shawn was evicted." << endl;
+	Record* result = h.get(1000101);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+	cout<< "hits " << h.stats().hits << ", misses " << h.stats().misses << ", evictions " << h.stats().evictions << endl;
+
+	// one million members, ten million lookups skewed toward a few of them
+	const int members = 1000000, lookups = 10000000;
+	vector<int> ids = zipfianIds(members, 0.99, lookups);
+	cout << endl << "read-through cache over " << members << " members, " << lookups << " Zipfian lookups" << endl;
+	for (int percent : {1, 5, 10}) {
+		size_t capacity = members / 100 * percent;
+		LruCache<int, Record> lru(capacity);
+		LruCache<int, Record, WyHash, equal_to<>, Eviction::CLOCK> clock(capacity);
+		double lruRate = readThrough(lru, ids);
+		double clockRate = readThrough(clock, ids);
+		cout<< "  " << percent << "% cached: LRU " << lru.stats().hitRate() * 100 << "% hits, " << lruRate
+		    << " M/s; CLOCK " << clock.stats().hitRate() * 100 << "% hits, " << clockRate << " M/s" << endl;
+	}
+
+	// hits only: what the cache itself costs once the working set is in it
+	const int cached = 100000;
+	LruCache<int, Record> lru(cached);
+	LruCache<int, Record, WyHash, equal_to<>, Eviction::CLOCK> clock(cached);
+	for (int id = 0; id < cached; id++) {
+		lru.put(id, loadRecord(id));
+		clock.put(id, loadRecord(id));
+	}
+	vector<int> hot = zipfianIds(cached, 0.99, lookups);
+	double lruRate = readThrough(lru, hot);
+	double clockRate = readThrough(clock, hot);
+	cout<< "  all hits, " << cached << " cached: LRU " << lruRate << " M/s, CLOCK " << clockRate << " M/s, "
+	    << lru.memoryUsage() / cached << " bytes per entry" << endl;
+
+    return 0;
+}
@@ -0,0 +1,287 @@
+#ifndef HASH_TABLES_LRU_CACHE_H
+#define HASH_TABLES_LRU_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "hash-functions.h"
+#include "slab-allocator.h"
+
+// How a full cache picks the entry to evict.
+//
+// LRU keeps the entries in order of last use: every hit moves its entry to
+// the front of the list, and the back is evicted.
+//
+// CLOCK (second chance) only sets a bit on a hit, so a hit writes one byte
+// instead of relinking the entry and both of its neighbours. At eviction the back of the list is
+// checked first: an entry whose bit is set is given a second chance (its bit
+// cleared, moved to the front) and the next one is checked, so entries used
+// since they last reached the back survive. It approximates LRU closely for
+// skewed workloads and makes hits cheaper.
+enum class Eviction { LRU, CLOCK };
+
+// Bounded cache: a chained hash table whose nodes are also linked into a
+// recency list.
+//
+// Each node carries the chain link of its bucket and the two links of the
+// doubly linked recency list, so get, put and evict are all O(1) with no
+// second container to keep in sync. Nodes come from a NodeSlab, one slot per
+// entry. Once the cache is full an eviction hands its node straight to the
+// entry being put, so a cache at its working size does not allocate at all.
+//
+// The bucket array is sized once for the capacity and never resized.
+// get() counts hits and misses; peek() looks without counting and without
+// refreshing the entry. Lookups take any key type Hasher and KeyEqual both
+// accept, e.g. a std::string_view for std::string keys with the defaults.
+template <class Key, class Value, class Hasher = WyHash, class KeyEqual = std::equal_to<>,
+          Eviction Policy = Eviction::LRU>
+class LruCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t inserts;
+        uint64_t evictions;
+
+        double hitRate() const { return hits + misses == 0 ? 0 : (double)hits / (hits + misses); }
+    };
+
+    explicit LruCache(size_t capacity, const Hasher& hasher = Hasher(), const KeyEqual& equal = KeyEqual())
+        : hasher_(hasher), equal_(equal), capacity_(capacity), size_(0), stats_() {
+        if (capacity < 1) throw std::invalid_argument("LruCache: capacity must be at least 1");
+        // at most 3 entries per 4 buckets
+        buckets_ = 1;
+        while (buckets_ / 4 * 3 < capacity && buckets_ < ((size_t)1 << 62)) buckets_ *= 2;
+        table_ = static_cast<Node**>(std::calloc(buckets_, sizeof(Node*)));
+        if (table_ == nullptr) throw std::bad_alloc();
+        list_.newer = list_.older = &list_;
+    }
+
+    ~LruCache() {
+        clear();
+        std::free(table_);
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // Returns the cached value and marks it used, or nullptr on a miss.
+    template <class Q>
+    Value* get(const Q& key) {
+        Node* node = findNode(key, hasher_(key));
+        if (node == nullptr) {
+            stats_.misses++;
+            return nullptr;
+        }
+        stats_.hits++;
+        touch(node);
+        return &node->value;
+    }
+
+    // Returns the cached value without counting or refreshing it.
+    template <class Q>
+    Value* peek(const Q& key) {
+        Node* node = findNode(key, hasher_(key));
+        return node == nullptr ? nullptr : &node->value;
+    }
+
+    template <class Q>
+    bool contains(const Q& key) {
+        return peek(key) != nullptr;
+    }
+
+    // Stores Value(args...) under key, replacing and refreshing an existing
+    // entry. When the cache is full the least recently used entry is evicted
+    // first. Returns the stored value.
+    template <class K, class... Args>
+    Value* put(K&& key, Args&&... args) {
+        uint64_t hash = hasher_(key);
+        Node* node = findNode(key, hash);
+        if (node != nullptr) {
+            node->value = Value(std::forward<Args>(args)...);
+            touch(node);
+            return &node->value;
+        }
+        return &insertNode(hash, std::forward<K>(key), std::forward<Args>(args)...)->value;
+    }
+
+    // Read-through: returns the cached value, or caches and returns load(key)
+    // on a miss. The key is hashed once either way.
+    template <class K, class Loader>
+    Value& fetch(K&& key, Loader&& load) {
+        uint64_t hash = hasher_(key);
+        Node* node = findNode(key, hash);
+        if (node != nullptr) {
+            stats_.hits++;
+            touch(node);
+            return node->value;
+        }
+        stats_.misses++;
+        Value value = load(key);
+        return insertNode(hash, std::forward<K>(key), std::move(value))->value;
+    }
+
+    // Returns false if the key is not cached.
+    template <class Q>
+    bool remove(const Q& key) {
+        uint64_t hash = hasher_(key);
+        Node** link = &table_[hash & (buckets_ - 1)];
+        while (*link != nullptr && !((*link)->hash == hash && equal_((*link)->key, key))) link = &(*link)->chain;
+        if (*link == nullptr) return false;
+
+        Node* node = *link;
+        *link = node->chain;
+        unlinkRecency(node);
+        node->~Node();
+        nodes_.deallocate(node);
+        size_--;
+        return true;
+    }
+
+    // Drops every entry; the statistics are kept.
+    void clear() {
+        for (Links* link = list_.newer; link != &list_;) {
+            Node* node = static_cast<Node*>(link);
+            link = link->newer;
+            node->~Node();
+        }
+        nodes_.release();
+        list_.newer = list_.older = &list_;
+        std::fill(table_, table_ + buckets_, nullptr);
+        size_ = 0;
+    }
+
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+
+    // Calls visit(const Key&, Value&) from the most to the least recently
+    // used entry (for CLOCK, in list order, ignoring the reference bits).
+    template <class Visitor>
+    void forEach(Visitor&& visit) {
+        for (Links* link = list_.older; link != &list_; link = link->older) {
+            Node* node = static_cast<Node*>(link);
+            visit(node->key, node->value);
+        }
+    }
+
+    // bytes owned by the cache: the bucket array and the node slabs
+    size_t memoryUsage() const { return buckets_ * sizeof(Node*) + nodes_.memoryUsage(); }
+
+private:
+    // the recency list is circular, through a sentinel that holds only links:
+    // list_.older is the most recently used entry, list_.newer the least
+    struct Links {
+        Links* newer;
+        Links* older;
+    };
+
+    struct Node : Links {
+        Node* chain;       // next node in the same bucket
+        uint64_t hash;     // kept so eviction can find the chain without rehashing the key
+        bool referenced;   // CLOCK: used since it last reached the back
+        Key key;
+        Value value;
+
+        template <class K, class... Args>
+        Node(uint64_t h, K&& k, Args&&... args)
+            : chain(nullptr), hash(h), referenced(false), key(std::forward<K>(k)), value(std::forward<Args>(args)...) {}
+    };
+
+    template <class Q>
+    Node* findNode(const Q& key, uint64_t hash) const {
+        Node* node = table_[hash & (buckets_ - 1)];
+        while (node != nullptr && !(node->hash == hash && equal_(node->key, key))) node = node->chain;
+        return node;
+    }
+
+    // a hit: LRU moves the node to the front, CLOCK only marks it
+    void touch(Node* node) {
+        if (Policy == Eviction::CLOCK) {
+            node->referenced = true;
+        } else if (list_.older != node) {
+            unlinkRecency(node);
+            pushFront(node);
+        }
+    }
+
+    void pushFront(Node* node) {
+        node->older = list_.older;
+        node->newer = &list_;
+        list_.older->newer = node;
+        list_.older = node;
+    }
+
+    static void unlinkRecency(Node* node) {
+        node->older->newer = node->newer;
+        node->newer->older = node->older;
+    }
+
+    // the node that goes next: the back of the list, after CLOCK has given
+    // every referenced node on the way a second chance
+    Node* victim() {
+        Node* node = static_cast<Node*>(list_.newer);
+        if (Policy == Eviction::CLOCK) {
+            while (node->referenced) {
+                node->referenced = false;
+                unlinkRecency(node);
+                pushFront(node);
+                node = static_cast<Node*>(list_.newer);
+            }
+        }
+        return node;
+    }
+
+    template <class K, class... Args>
+    Node* insertNode(uint64_t hash, K&& key, Args&&... args) {
+        void* slot;
+        if (size_ == capacity_) {
+            Node* old = victim();
+            Node** link = &table_[old->hash & (buckets_ - 1)];
+            while (*link != old) link = &(*link)->chain;
+            *link = old->chain;
+            unlinkRecency(old);
+            old->~Node();
+            slot = old;
+            size_--;
+            stats_.evictions++;
+        } else {
+            slot = nodes_.allocate();
+        }
+
+        Node* node;
+        try {
+            node = new (slot) Node(hash, std::forward<K>(key), std::forward<Args>(args)...);
+        } catch (...) {
+            nodes_.deallocate(slot);
+            throw;
+        }
+        Node*& head = table_[hash & (buckets_ - 1)];
+        node->chain = head;
+        head = node;
+        pushFront(node);
+        size_++;
+        stats_.inserts++;
+        return node;
+    }
+
+    Hasher hasher_;
+    KeyEqual equal_;
+    NodeSlab<Node> nodes_;
+    Links list_;         // sentinel of the recency list
+    Node** table_;       // chain heads
+    size_t buckets_;     // a power of two
+    size_t capacity_;    // most entries held at once
+    size_t size_;
+    Stats stats_;
+};
+
+#endif
@@ -1,139 +1,27 @@
 #include <iostream>
 #include <string>
+#include <chrono>
+#include "open-addressing.h"
+#include "hash-table.h"
 using namespace std;
 
-const int CAPACITY = 2000; //in this simple demo, fixed capacity is used.
-
-// declaration and definition
-
-class Node { // the node
-public: 	//set public for simplicity
-      int idNumber;
-      string idName;
-      string emailAddress;
-      // ... ... other attributes
-
-      Node *next;
-
-      Node(int num, string name, string email):  idNumber(num), idName(name), emailAddress(email) , next (NULL) {};
-};
-
-
-class HashTable {
-
-	public:  	//set public for simplicity
-      Node **table;  //to be pointed to the array of linked lists
-
-      //in this simple demo, fixed capacity is used. size of current number of items is not tracked.
-
-      HashTable() {
-            table = new Node*[CAPACITY];
-
-            for (int i = 0; i < CAPACITY; i++)
-                  table[i] = NULL;
-      }
-
-
-      ~HashTable() {
-            for (int i = 0; i < CAPACITY; i++)
-                  if (table[i] != NULL) {
-                        Node *prevNode = NULL;
-                        Node *temp = table[i];
-                        while (temp != NULL) {
-                             prevNode = temp;
-                             temp = temp->next;
-                             delete prevNode;
-                        }
-                  }
-            delete[] table;
-      }
-
-	   int hashFunction (string str){
-	   		int length = str.length();
-   			int sum = 0;
-   			for (int i=0; i < length; i++)  sum = sum + (int)str[i];   //str[i] gets the ith char in the string
-
-   			if(sum < 0) sum = -1 * sum; //	(if sum exceeds the max int, it will become negative, then just change it to positive.)
-
-   			return sum % CAPACITY;
-	   }
-
-
-      Node* search(string name) {
-
-            int hashIndex = hashFunction ( name );
-
-            if (table[hashIndex] == NULL)   return NULL;
-            else {
-                  Node *temp = table[hashIndex];
-                  while (temp != NULL && temp->idName != name) temp = temp->next;
-                  if (temp == NULL) return NULL;
-                  else              return temp;
-            }
-      }
-
-
-
-      void insert(int num, string name, string email) {
-      		if (  search (name) ) {
-      			cout << "cannot insert when the same key exists." << endl;
-      			return;
-			}
-
-            int hashIndex = hashFunction ( name );
-
-            if (table[hashIndex] == NULL) table[hashIndex] = new Node(num, name, email);
-
-            else {
-                  Node *temp = table[hashIndex];
-                  while (temp->next != NULL) temp = temp->next;
-                  temp->next = new Node(num, name, email);
-            }
-
-        // here could increase size by one and check if size is too large for adjustable capacity.
-		// e.g., when size reaches 75% of capacity, double the capacity.
-      }
-
-      void remove(string name) {
-      		if (  search (name) == NULL ) {
-      			cout << "cannot remove when the key does not exist." << endl;
-      			return;
-			}
-            int hashIndex = hashFunction ( name );
-
-            if (table[hashIndex] != NULL) {
-                  Node *prevNode = NULL;
-                  Node *temp = table[hashIndex];
-
-				  // find the target
-                  while (temp->idName != name && temp->next != NULL) {
-                        prevNode = temp;
-                        temp = temp->next;
-                  }
-
-                  // temp should be the target now.
-                  if (temp->idName == name) {
-                        if (prevNode == NULL) { //it is the first node
-                             Node *nextNode = temp->next;
-                             delete temp;
-                             table[hashIndex] = nextNode;
-                        } else { // it is not the first node
-                             Node *nextNode = temp->next;
-                             delete temp;
-                             prevNode->next = nextNode;
-                        }
-                  }
-            }
-        // here could do size--, and check if size is too small for adjustable capacity.
-		// e.g., when size is less than 20% of capacity, reduce capacity by half.
-      }
-
-};
+// Records are keyed on idName and stored densely in a flat array, apart from
+// the slots that are probed. see open-addressing.h for the Robin Hood probing
+// and backward shift delete.
+
+void printProbeStats(const RobinHoodHashTable<>& h) {
+	RobinHoodHashTable<>::ProbeStats stats = h.probeStats();
+	cout<< "size " << stats.size << ", capacity " << stats.capacity
+	    << ", mean probe length " << stats.meanProbeLength << ", max probe length " << stats.maxProbeLength << endl;
+	for (unsigned int d = 0; d < stats.histogram.size(); d++)
+		cout<< "  probe length " << d << ": " << stats.histogram[d] << endl;
+	cout<< "  table bytes per entry: " << (double)h.memoryUsage() / stats.size << endl;
+}
 
 
 int main()
 {
-	HashTable h;
+	RobinHoodHashTable<> h;
 
 	h.insert(1000101, "jacob",  "jacob23@uw.ca");
 	h.insert(2001201, "shawn",  "shawn3@uw.ca");
@@ -154,12 +42,61 @@ int main()
 	cout<< h.hashFunction( "emily" ) << endl;
 	cout<< h.hashFunction( "mary" ) << endl;
 
-	h.insert(1000101, "jacob",  "jacob23@uw.ca");
-	h.remove("jack");
+	if ( !h.insert(1000101, "jacob",  "jacob23@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.remove("jack") )
+		cout << "cannot remove when the key does not exist." << endl;
 
-	Node* result;
+	Record* result;
 	result = h.search("grace");
 	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
 
+	h.remove("grace");
+	cout<< (h.search("grace") == NULL ? "grace removed" : "grace still there") << endl;
+	printProbeStats(h);
+
+	// a bigger table to show how tight Robin Hood keeps the probe lengths
+	// and how its memory compares with separate chaining on the same records
+	RobinHoodHashTable<> big;
+	HashTable<string, Record> chained;
+	for (int i = 0; i < 100000; i++) {
+		big.insert(i, "user" + to_string(i), "user@uw.ca");
+		chained.emplace("user" + to_string(i), i, "user" + to_string(i), "user@uw.ca");
+	}
+	cout<< "table bytes per entry: robin hood " << (double)big.memoryUsage() / big.size()
+	    << ", chaining " << (double)chained.memoryUsage() / chained.size() << endl;
+	for (int i = 0; i < 100000; i += 2) {
+		big.remove("user" + to_string(i));
+		chained.remove("user" + to_string(i));
+	}
+	printProbeStats(big);
+	cout<< "  chaining table bytes per entry: " << (double)chained.memoryUsage() / chained.size() << endl;
+	result = big.search("user99999");
+	cout<< result->idNumber << ", "<< result->idName << endl;
+
+	// every insert and remove is timed: growing adds a record chunk and
+	// resizing moves a few slots per operation, so none of them should cost
+	// anything like a pass over the whole table
+	typedef chrono::steady_clock Clock;
+	RobinHoodHashTable<> timed;
+	const int TIMED = 4000000;
+	double worstInsert = 0, worstRemove = 0;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < TIMED; i++) {
+		string name = "user" + to_string(i);
+		Clock::time_point before = Clock::now();
+		timed.insert(i, name, "user@uw.ca");
+		worstInsert = max(worstInsert, chrono::duration<double, micro>(Clock::now() - before).count());
+	}
+	for (int i = 0; i < TIMED; i++) {
+		string name = "user" + to_string(i);
+		Clock::time_point before = Clock::now();
+		timed.remove(name);
+		worstRemove = max(worstRemove, chrono::duration<double, micro>(Clock::now() - before).count());
+	}
+	double mean = chrono::duration<double, micro>(Clock::now() - start).count() / (2.0 * TIMED);
+	cout<< TIMED << " inserts then removes: mean " << mean << " us, worst insert " << worstInsert
+	    << " us, worst remove " << worstRemove << " us" << endl;
+
     return 0;
 }
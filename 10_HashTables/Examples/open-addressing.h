@@ -0,0 +1,392 @@
+#ifndef HASH_TABLES_OPEN_ADDRESSING_H
+#define HASH_TABLES_OPEN_ADDRESSING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "record.h"
+
+// Open addressing hash table keyed on idName, using Robin Hood linear probing.
+//
+// There are no per-item nodes or pointers. Records are kept densely, the
+// first size() positions of an array of fixed-size chunks, and the probe
+// sequence runs over a separate array of 8-byte slots. A slot holds the cached hash of its
+// key and the position of its record. Its probe distance (how far it sits
+// from its home slot) follows from the hash, so it is not stored. Probing,
+// Robin Hood swaps and backward shifts only touch slots, never records, and
+// a record is only read to compare the key once the cached hash matches.
+//
+// Robin Hood rule: while probing for a free slot, an item that is further from
+// its home than the resident item takes the slot, and the resident continues
+// probing instead. This keeps probe distances close to each other, and lets a
+// search stop as soon as it meets an item closer to home than the key would be.
+//
+// Deletes use backward shift: the slots after the removed one are moved back
+// by one until an empty slot or one already at its home is reached. No
+// tombstones are left behind, so searches never slow down after deletes. The
+// last record then moves into the removed record's place, and its slot is
+// pointed there, so the records stay dense.
+//
+// The record array grows by adding a chunk of CHUNK_RECORDS and shrinks by
+// freeing the last one, so no record is ever moved to make room: only the
+// array of chunk pointers is reallocated, one pointer per chunk.
+//
+// Growing and shrinking the slot array is incremental, as in HashTable: a
+// resize allocates the new slots and every insert, search and remove moves a
+// few old slots over (see rehashStep), so no operation pays an O(n) rehash.
+// Records stay where they are. New slot arrays come from calloc, whose large
+// blocks are zeroed lazily page by page, and a zero hash marks an empty slot. While a resize runs, the old slots keep their
+// probe structure: a slot that has moved on, or whose item was removed, is
+// marked MOVED but keeps its hash, so searches in the old slots stop exactly
+// where they would have. Backward shift is only ever done in the new slots.
+//
+// Hasher is a policy from hash-functions.h.
+template <class Hasher = WyHash>
+class RobinHoodHashTable {
+public:
+    // Summary of probe distances, where 0 means the item sits in its home slot.
+    struct ProbeStats {
+        unsigned int size;
+        unsigned int capacity;
+        unsigned int maxProbeLength;
+        double meanProbeLength;
+        // histogram[d] = number of items that sit d slots from their home slot
+        std::vector<unsigned int> histogram;
+    };
+
+    // Table grows when it would become fuller than MAX_LOAD_NUM / MAX_LOAD_DEN,
+    // and shrinks by half when it drops below a quarter full.
+    static const unsigned int MAX_LOAD_NUM = 7;
+    static const unsigned int MAX_LOAD_DEN = 8;
+    static const unsigned int MIN_CAPACITY = 16;
+    // old slots moved to the new array by every insert, search and remove
+    // while growing. a grow from C slots leaves at least 7C/8 inserts before
+    // the next one, so 8 a step finishes long before.
+    static const unsigned int MIGRATE_SLOTS = 8;
+    // the same while shrinking: a shrink from C slots starts below C/4 items
+    // and the next is due below C/8, so the C old slots have to be moved in
+    // fewer than C/8 removes. most of them are empty.
+    static const unsigned int SHRINK_MIGRATE_SLOTS = 32;
+    // records per chunk of the record array: 4.5 KiB of 72-byte records
+    static const unsigned int CHUNK_SHIFT = 6;
+    static const unsigned int CHUNK_RECORDS = 1u << CHUNK_SHIFT;
+
+    explicit RobinHoodHashTable(unsigned int initialCapacity = MIN_CAPACITY, const Hasher& hasher = Hasher())
+        : hasher_(hasher), slots_(nullptr), capacity_(0), mask_(0),
+          size_(0), oldSlots_(nullptr), oldCapacity_(0), migrateIndex_(0), migrateStep_(MIGRATE_SLOTS) {
+        unsigned int cap = MIN_CAPACITY;
+        while (cap < initialCapacity) cap *= 2;
+        slots_ = allocateSlots(cap);
+        capacity_ = cap;
+        mask_ = cap - 1;
+    }
+
+    ~RobinHoodHashTable() {
+        for (unsigned int i = 0; i < size_; ++i) record(i).~Record();
+        for (Record* chunk : chunks_) std::free(chunk);
+        std::free(slots_);
+        std::free(oldSlots_);
+    }
+
+    RobinHoodHashTable(const RobinHoodHashTable&) = delete;
+    RobinHoodHashTable& operator=(const RobinHoodHashTable&) = delete;
+
+    unsigned int size() const { return size_; }
+    // slots in the newest slot array
+    unsigned int capacity() const { return capacity_; }
+    bool resizing() const { return oldSlots_ != nullptr; }
+
+    // Low 32 bits of the hasher's output, never 0 (the hash of an empty slot).
+    uint32_t hashString(const std::string& str) const {
+        uint32_t hash = (uint32_t)hasher_(str);
+        return hash == 0 ? 1 : hash;
+    }
+
+    // home slot of the given key
+    unsigned int hashFunction(const std::string& name) const {
+        return hashString(name) & mask_;
+    }
+
+    // The record stored under name, or nullptr. The pointer is valid until
+    // the next insert or remove.
+    Record* search(const std::string& name) {
+        rehashStep();
+        uint32_t hash = hashString(name);
+        Slot* slot = findSlot(name, hash);
+        if (slot == nullptr) slot = findOld(name, hash);
+        return slot == nullptr ? nullptr : &record(slot->index);
+    }
+
+    // Returns false (and leaves the table unchanged) if the key already exists.
+    // The probe that rules out a duplicate stops exactly where the new slot
+    // belongs, so placement continues from there instead of probing again.
+    bool insert(int num, const std::string& name, const std::string& email) {
+        rehashStep();
+        uint32_t hash = hashString(name);
+        unsigned int stop = 0;
+        if (findSlot(name, hash, &stop) != nullptr || findOld(name, hash) != nullptr) return false;
+
+        if (size_ == chunks_.size() * CHUNK_RECORDS) addChunk();
+        new (&record(size_)) Record(num, name, email);
+        Slot slot = {hash, size_};
+        size_++;
+
+        if ((unsigned long long)size_ * MAX_LOAD_DEN > (unsigned long long)capacity_ * MAX_LOAD_NUM) {
+            // inserts never outrun a migration (see MIGRATE_SLOTS), but if
+            // they did, the old slots would be moved over all at once here
+            while (resizing()) rehashStep();
+            startResize(capacity_ * 2);
+            place(slot);
+        } else {
+            place(slot, stop);
+        }
+        return true;
+    }
+
+    // Returns false if the key does not exist.
+    bool remove(const std::string& name) {
+        rehashStep();
+        uint32_t hash = hashString(name);
+        Slot* slot = findSlot(name, hash);
+        uint32_t index;
+        if (slot != nullptr) {
+            index = slot->index;
+            shiftBack((unsigned int)(slot - slots_));
+        } else {
+            slot = findOld(name, hash);
+            if (slot == nullptr) return false;
+            // the old slots keep their probe structure: only mark it
+            index = slot->index;
+            slot->index = MOVED;
+        }
+
+        // keep the records dense: the last one fills the hole
+        uint32_t last = size_ - 1;
+        if (index != last) {
+            record(index) = std::move(record(last));
+            slotOf(hashString(record(index).idName), last)->index = index;
+        }
+        record(last).~Record();
+        size_--;
+        // keep one empty chunk spare, so a size going back and forth across
+        // a chunk boundary does not free and allocate every time
+        if (chunks_.size() >= 2 && size_ <= (chunks_.size() - 2) * CHUNK_RECORDS) {
+            std::free(chunks_.back());
+            chunks_.pop_back();
+        }
+
+        checkLoad();
+        return true;
+    }
+
+    // Probe distances of every item, in whichever slot array it is in.
+    ProbeStats probeStats() const {
+        ProbeStats stats;
+        stats.size = size_;
+        stats.capacity = capacity_;
+        stats.maxProbeLength = 0;
+        unsigned long long total = 0;
+        countProbes(slots_, capacity_, stats, total);
+        countProbes(oldSlots_, oldCapacity_, stats, total);
+        stats.meanProbeLength = size_ == 0 ? 0.0 : (double)total / size_;
+        return stats;
+    }
+
+    // Bytes owned by the table itself (the record chunks and both slot arrays
+    // while resizing), not counting string heap buffers.
+    size_t memoryUsage() const {
+        return chunks_.size() * (CHUNK_RECORDS * sizeof(Record) + sizeof(Record*))
+            + ((size_t)capacity_ + oldCapacity_) * sizeof(Slot);
+    }
+
+private:
+    // index of an old slot whose item has moved to the new slots or been removed
+    static const uint32_t MOVED = 0xFFFFFFFE;
+
+    struct Slot {
+        uint32_t hash;      // 0 for an empty slot
+        uint32_t index;     // position of the record, or MOVED
+    };
+
+    // probe distance + 1 of a slot at position pos, 0 for an empty one
+    static uint32_t distanceAt(const Slot& slot, unsigned int pos, unsigned int mask) {
+        if (slot.hash == 0) return 0;
+        return ((pos - slot.hash) & mask) + 1;
+    }
+
+    // all empty. calloc hands back lazily zeroed pages for large arrays, so
+    // starting a resize does not touch every new slot up front.
+    static Slot* allocateSlots(unsigned int cap) {
+        Slot* slots = static_cast<Slot*>(std::calloc(cap, sizeof(Slot)));
+        if (slots == nullptr) throw std::bad_alloc();
+        return slots;
+    }
+
+    // the record at position index of the record array
+    Record& record(uint32_t index) const {
+        return chunks_[index >> CHUNK_SHIFT][index & (CHUNK_RECORDS - 1)];
+    }
+
+    void addChunk() {
+        Record* chunk = static_cast<Record*>(std::malloc(CHUNK_RECORDS * sizeof(Record)));
+        if (chunk == nullptr) throw std::bad_alloc();
+        try {
+            chunks_.push_back(chunk);
+        } catch (...) {
+            std::free(chunk);
+            throw;
+        }
+    }
+
+    static void countProbes(const Slot* slots, unsigned int cap, ProbeStats& stats, unsigned long long& total) {
+        for (unsigned int i = 0; i < cap; ++i) {
+            if (slots[i].hash == 0 || slots[i].index == MOVED) continue;
+            unsigned int probe = distanceAt(slots[i], i, cap - 1) - 1;
+            if (probe >= stats.histogram.size()) stats.histogram.resize(probe + 1, 0);
+            stats.histogram[probe]++;
+            total += probe;
+            if (probe > stats.maxProbeLength) stats.maxProbeLength = probe;
+        }
+    }
+
+    // Returns the slot of name in the new slots, or nullptr. On a miss, stop
+    // (if given) receives the position where name would be placed.
+    Slot* findSlot(const std::string& name, uint32_t hash, unsigned int* stop = nullptr) const {
+        return findIn(slots_, mask_, name, hash, stop);
+    }
+
+    // The same in the old slots while resizing, else nullptr.
+    Slot* findOld(const std::string& name, uint32_t hash) const {
+        if (oldSlots_ == nullptr) return nullptr;
+        return findIn(oldSlots_, oldCapacity_ - 1, name, hash, nullptr);
+    }
+
+    Slot* findIn(Slot* slots, unsigned int mask, const std::string& name, uint32_t hash, unsigned int* stop) const {
+        unsigned int pos = hash & mask;
+        for (uint32_t distance = 1; ; ++distance) {
+            Slot& slot = slots[pos];
+            // an empty slot, or a resident closer to home than we would be, ends the search
+            if (distanceAt(slot, pos, mask) < distance) {
+                if (stop != nullptr) *stop = pos;
+                return nullptr;
+            }
+            if (slot.hash == hash && slot.index != MOVED && record(slot.index).idName == name) return &slot;
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    // the slot, new or old, that points at the record at index
+    Slot* slotOf(uint32_t hash, uint32_t index) const {
+        for (unsigned int pos = hash & mask_; slots_[pos].hash != 0; pos = (pos + 1) & mask_) {
+            if (slots_[pos].index == index) return &slots_[pos];
+        }
+        unsigned int mask = oldCapacity_ - 1;
+        for (unsigned int pos = hash & mask; ; pos = (pos + 1) & mask) {
+            if (oldSlots_[pos].index == index) return &oldSlots_[pos];
+        }
+    }
+
+    // Robin Hood insertion of a slot into the new slots, starting at the
+    // given position (its home by default).
+    void place(Slot incoming) {
+        place(incoming, incoming.hash & mask_);
+    }
+
+    void place(Slot carry, unsigned int pos) {
+        uint32_t distance = distanceAt(carry, pos, mask_);
+        while (true) {
+            Slot& slot = slots_[pos];
+            uint32_t resident = distanceAt(slot, pos, mask_);
+            if (resident == 0) {
+                slot = carry;
+                return;
+            }
+            if (resident < distance) {
+                // take from the rich: the resident is closer to home, so it moves on instead
+                std::swap(slot, carry);
+                distance = resident;
+            }
+            pos = (pos + 1) & mask_;
+            distance++;
+        }
+    }
+
+    // empties the new slot at pos and pulls each following displaced slot
+    // one closer to home
+    void shiftBack(unsigned int pos) {
+        unsigned int next = (pos + 1) & mask_;
+        while (distanceAt(slots_[next], next, mask_) > 1) {
+            slots_[pos] = slots_[next];
+            pos = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[pos].hash = 0;
+    }
+
+    // starts a resize if the load is outside [1/4, 7/8] and none is running
+    void checkLoad() {
+        if (resizing()) return;
+        if ((unsigned long long)size_ * MAX_LOAD_DEN > (unsigned long long)capacity_ * MAX_LOAD_NUM)
+            startResize(capacity_ * 2);
+        else if (capacity_ > MIN_CAPACITY && size_ * 4 < capacity_)
+            startResize(capacity_ / 2);
+    }
+
+    // keeps the current slots as the old ones and allocates new ones. the
+    // slots are moved over by rehashStep; the records stay where they are.
+    void startResize(unsigned int newCapacity) {
+        if (newCapacity < capacity_) migrateStep_ = SHRINK_MIGRATE_SLOTS;
+        else migrateStep_ = MIGRATE_SLOTS;
+        Slot* slots = allocateSlots(newCapacity);
+        oldSlots_ = slots_;
+        oldCapacity_ = capacity_;
+        migrateIndex_ = 0;
+        slots_ = slots;
+        capacity_ = newCapacity;
+        mask_ = newCapacity - 1;
+    }
+
+    // moves up to migrateStep_ old slots into the new ones, marking them
+    // MOVED. once the last one is moved, the load may already call for the
+    // next resize.
+    void rehashStep() {
+        if (oldSlots_ == nullptr) return;
+
+        unsigned int end = oldCapacity_ - migrateIndex_ < migrateStep_ ? oldCapacity_ : migrateIndex_ + migrateStep_;
+        for (; migrateIndex_ < end; ++migrateIndex_) {
+            Slot& slot = oldSlots_[migrateIndex_];
+            if (slot.hash == 0 || slot.index == MOVED) continue;
+            place(slot);
+            slot.index = MOVED;
+        }
+
+        if (migrateIndex_ == oldCapacity_) {
+            std::free(oldSlots_);
+            oldSlots_ = nullptr;
+            oldCapacity_ = 0;
+            checkLoad();
+        }
+    }
+
+    Hasher hasher_;
+    // size_ records in front, the rest unconstructed
+    std::vector<Record*> chunks_;
+    Slot* slots_;
+    unsigned int capacity_;     // slots, always a power of two
+    unsigned int mask_;
+    unsigned int size_;
+
+    // while a resize is in progress the slots are split between two arrays.
+    // old slots below migrateIndex_ have already been moved.
+    Slot* oldSlots_;
+    unsigned int oldCapacity_;
+    unsigned int migrateIndex_;
+    unsigned int migrateStep_;  // old slots moved per operation
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <random>
+#include "perfect-hash.h"
+#include "hash-table.h"
+using namespace std;
+
+// Builds a StaticHashMap from each line of a key file to its line number.
+// See perfect-hash.h.
+//
+// usage: perfect-hash [keyfile] [output.bin | output.h] [threads] [gamma]
+//
+// The key file holds one key per line; blank lines are skipped. Without one
+// the map is built for a million generated names. With an output file the
+// map is written as raw 64-bit words (.bin), or as a header that compiles the
+// same words into the program (.h).
+
+static double millisecondsSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// "out/wordlist.h" -> "wordlist", usable as a C++ identifier
+static string identifierFor(const string& path) {
+	size_t slash = path.find_last_of("/\\");
+	string name = path.substr(slash == string::npos ? 0 : slash + 1);
+	name = name.substr(0, name.find('.'));
+	for (char& c : name)
+		if (!isalnum((unsigned char)c)) c = '_';
+	if (name.empty() || isdigit((unsigned char)name[0])) name = "keys_" + name;
+	return name;
+}
+
+static void writeHeader(const string& path, const string& source, size_t keys, const vector<uint64_t>& words) {
+	string name = identifierFor(path);
+	string guard = name;
+	for (char& c : guard) c = (char)toupper((unsigned char)c);
+	ofstream out(path);
+	out << "// Generated by perfect-hash from " << source << ": " << keys << " keys." << endl
+	    << "// A StaticHashMap<uint32_t> from each key to its line number, loaded with" << endl
+	    << "//     StaticHashMap<uint32_t> " << name << "(" << name << "_words, " << name << "_count);" << endl
+	    << "#ifndef " << guard << "_PERFECT_HASH_H" << endl
+	    << "#define " << guard << "_PERFECT_HASH_H" << endl << endl
+	    << "#include <cstddef>" << endl
+	    << "#include <cstdint>" << endl << endl
+	    << "static const size_t " << name << "_count = " << words.size() << ";" << endl
+	    << "static const uint64_t " << name << "_words[] = {";
+	out << hex << setfill('0');
+	for (size_t i = 0; i < words.size(); i++)
+		out << (i % 4 == 0 ? "\n    " : " ") << "0x" << setw(16) << words[i] << "ull,";
+	out << dec << endl << "};" << endl << endl << "#endif" << endl;
+}
+
+
+int main(int argc, char* argv[])
+{
+	string keyFile = argc > 1 ? argv[1] : "";
+	string output = argc > 2 ? argv[2] : "";
+	unsigned int threads = argc > 3 ? atoi(argv[3]) : thread::hardware_concurrency();
+	double gamma = argc > 4 ? atof(argv[4]) : 1.0;
+
+	vector<string> keys;
+	vector<uint32_t> lines;
+	if (keyFile.empty()) {
+		for (int i = 0; i < 1000000; i++) {
+			keys.push_back("member" + to_string(i));
+			lines.push_back(i + 1);
+		}
+		keyFile = "generated names";
+	} else {
+		ifstream in(keyFile);
+		if (!in) {
+			cerr << "cannot open " << keyFile << endl;
+			return 1;
+		}
+		string line;
+		for (uint32_t number = 1; getline(in, line); number++) {
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (line.empty()) continue;
+			keys.push_back(line);
+			lines.push_back(number);
+		}
+		if (keys.empty()) {
+			cerr << "no keys in " << keyFile << endl;
+			return 1;
+		}
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	StaticHashMap<uint32_t> map;
+	try {
+		map = StaticHashMap<uint32_t>(keys, lines, gamma, threads);
+	} catch (const exception& e) {
+		cerr << keyFile << ": " << e.what() << endl;
+		return 1;
+	}
+	cout << keys.size() << " keys from " << keyFile << " in " << millisecondsSince(start) << " ms on "
+	     << threads << " thread(s)" << endl;
+	cout << "function: " << map.function().levels() << " levels, " << map.function().bitsPerKey()
+	     << " bits per key" << endl;
+
+	if (!output.empty()) {
+		vector<uint64_t> words = map.serialize();
+		if (output.size() > 2 && output.compare(output.size() - 2, 2, ".h") == 0) {
+			writeHeader(output, keyFile, keys.size(), words);
+		} else {
+			ofstream out(output, ios::binary);
+			out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+		}
+		cout << "wrote " << words.size() * sizeof(uint64_t) << " bytes to " << output << endl;
+
+		// the map loads back from nothing but its words
+		map = StaticHashMap<uint32_t>(words.data(), words.size());
+	}
+
+	// every key finds its own line, and nothing else is found
+	size_t wrong = 0;
+	for (size_t i = 0; i < keys.size(); i++) {
+		const uint32_t* line = map.search(keys[i]);
+		if (line == NULL || *line != lines[i]) wrong++;
+	}
+	for (size_t i = 0; i < keys.size(); i++)
+		if (map.contains(keys[i] + "#")) wrong++;
+	cout << (wrong == 0 ? "every key found, no stranger found" : "WRONG ANSWERS: " + to_string(wrong)) << endl;
+
+	HashTable<string, uint32_t> chained;
+	for (size_t i = 0; i < keys.size(); i++) chained.insert(keys[i], lines[i]);
+
+	// look the keys up in a random order, not the order they were inserted in
+	vector<string> lookups = keys;
+	shuffle(lookups.begin(), lookups.end(), mt19937(42));
+
+	const int rounds = keys.size() < 100000 ? 20 : 2;
+	uint64_t sum[2] = {0, 0};
+	start = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (const string& key : lookups) sum[0] += *map.search(key);
+	double perfectRate = rounds * keys.size() / millisecondsSince(start) / 1e3;
+	start = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (const string& key : lookups) sum[1] += *chained.search(key);
+	double chainedRate = rounds * keys.size() / millisecondsSince(start) / 1e3;
+
+	cout<< "perfect hash map: " << perfectRate << " M lookups/s, "
+	    << map.serialize().size() * sizeof(uint64_t) / keys.size() << " bytes per key" << endl;
+	cout<< "chained table:    " << chainedRate << " M lookups/s, "
+	    << chained.memoryUsage() / keys.size() << " bytes per key" << (sum[0] == sum[1] ? "" : " (sums differ)") << endl;
+
+    return 0;
+}
@@ -0,0 +1,378 @@
+#ifndef HASH_TABLES_PERFECT_HASH_H
+#define HASH_TABLES_PERFECT_HASH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+
+namespace perfect_hash {
+
+// Runs body(begin, end) over [0, count) split into one slice per thread.
+// Fewer than grain items are not worth starting threads for, and run on
+// the calling thread.
+template <class Body>
+void parallelFor(size_t count, unsigned int threads, const Body& body, size_t grain = 4096) {
+    if (threads <= 1 || count < grain) {
+        body(0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    size_t slice = (count + threads - 1) / threads;
+    for (size_t begin = 0; begin < count; begin += slice)
+        workers.emplace_back(body, begin, std::min(count, begin + slice));
+    for (std::thread& worker : workers) worker.join();
+}
+
+// set bits in x; the builtin becomes a library call unless the target is
+// known to have a popcount instruction
+inline unsigned int popcount(uint64_t x) {
+    x -= (x >> 1) & 0x5555555555555555ull;
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (unsigned int)((x * 0x0101010101010101ull) >> 56);
+}
+
+// maps a 64-bit hash onto [0, range) without a division
+inline uint64_t reduce(uint64_t hash, uint64_t range) {
+    return (uint64_t)(((__uint128_t)hash * range) >> 64);
+}
+
+}  // namespace perfect_hash
+
+
+// Minimal perfect hash over a key set that is known up front (BBHash).
+//
+// The function maps the n keys it was built from onto 0..n-1 with no
+// collisions. It is a cascade of bit arrays: at level 0 every key is hashed
+// into an array of about gamma * n bits, and the keys that landed on a bit of
+// their own set it. The keys that collided are hashed again, with a different
+// seed, into a smaller array at level 1, and so on until every key has a bit.
+// A key's value is the number of set bits before its bit, which a rank table
+// sampled every 256 bits answers with one lookup and four popcounts.
+//
+// With gamma = 1 a key is alone on its bit with probability 1/e, so each
+// level holds about 37% of the keys that reach it and the arrays add up to
+// roughly e * n bits. With the rank table that is a little over 3 bits per
+// key. A larger gamma spends more bits to stop more keys at the first levels.
+// It does not store the keys: a key outside the set gets an arbitrary index,
+// or NOT_FOUND, and the caller has to compare against the key it finds there.
+//
+// Each level is built by all threads at once: two atomic bit arrays record
+// which bits were hit and which were hit twice, then each thread collects the
+// collided keys of its own slice for the next level.
+//
+// serialize() flattens the function into 64-bit words, which load back with
+// the constructor that takes words, from a file or from an array compiled
+// into the program. The words are in native byte order, and the same Hasher
+// has to be used to load them as to build them.
+template <class Hasher = WyHash>
+class MinimalPerfectHash {
+public:
+    static const size_t NOT_FOUND = ~(size_t)0;
+    static const unsigned int MAX_LEVELS = 32;
+    static const unsigned int RANK_BLOCK = 4;    // 64-bit words per rank sample
+    static constexpr uint64_t MAGIC = 0x3148504d48535048ull;    // "HPSHMPH1"
+
+    MinimalPerfectHash() : size_(0), seed_(0) {}
+
+    // builds the function for keys, which must not repeat
+    template <class Key>
+    MinimalPerfectHash(const std::vector<Key>& keys, double gamma = 1.0,
+                       unsigned int threads = std::thread::hardware_concurrency(),
+                       const Hasher& hasher = Hasher(), uint64_t seed = 0)
+        : hasher_(hasher), size_(keys.size()), seed_(seed) {
+        if (threads < 1) threads = 1;
+        std::vector<uint64_t> hashes(keys.size());
+        perfect_hash::parallelFor(keys.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) hashes[i] = hasher_(keys[i]);
+        });
+        build(std::move(hashes), gamma < 0.5 ? 0.5 : gamma, threads);
+    }
+
+    // loads a function written by serialize()
+    MinimalPerfectHash(const uint64_t* words, size_t count, const Hasher& hasher = Hasher())
+        : hasher_(hasher) {
+        load(words, count);
+    }
+
+    // index of key in 0..size()-1, if key was one of the keys built from
+    template <class Q>
+    size_t operator()(const Q& key) const {
+        uint64_t hash = hasher_(key);
+        for (unsigned int level = 0; level < levelBits_.size(); ++level) {
+            uint64_t bit = levelStart_[level] + perfect_hash::reduce(levelHash(hash, level), levelBits_[level]);
+            if (bits_[bit / 64] & ((uint64_t)1 << (bit % 64))) return rank(bit);
+        }
+        // the few keys no level placed are kept sorted by hash after the ranked keys
+        std::vector<uint64_t>::const_iterator it = std::lower_bound(leftover_.begin(), leftover_.end(), hash);
+        if (it == leftover_.end() || *it != hash) return NOT_FOUND;
+        return size_ - leftover_.size() + (it - leftover_.begin());
+    }
+
+    size_t size() const { return size_; }
+    unsigned int levels() const { return (unsigned int)levelBits_.size(); }
+
+    // bits of metadata per key, bit arrays, rank table and leftovers together
+    double bitsPerKey() const {
+        return size_ == 0 ? 0 : (double)serializedWords() * 64 / size_;
+    }
+
+    size_t serializedWords() const {
+        return 6 + 2 * levelBits_.size() + bits_.size() + (ranks_.size() + 1) / 2 + leftover_.size();
+    }
+
+    // appends the function to words
+    void serialize(std::vector<uint64_t>& words) const {
+        words.push_back(MAGIC);
+        words.push_back(size_);
+        words.push_back(seed_);
+        words.push_back(levelBits_.size());
+        words.push_back(bits_.size());
+        words.push_back(leftover_.size());
+        for (size_t level = 0; level < levelBits_.size(); ++level) {
+            words.push_back(levelStart_[level]);
+            words.push_back(levelBits_[level]);
+        }
+        words.insert(words.end(), bits_.begin(), bits_.end());
+        for (size_t i = 0; i < ranks_.size(); i += 2)
+            words.push_back(ranks_[i] | (i + 1 < ranks_.size() ? (uint64_t)ranks_[i + 1] << 32 : 0));
+        words.insert(words.end(), leftover_.begin(), leftover_.end());
+    }
+
+    // reads a function written by serialize(); returns the words it used
+    size_t load(const uint64_t* words, size_t count) {
+        if (count < 6 || words[0] != MAGIC) throw std::invalid_argument("not a perfect hash function");
+        size_ = words[1];
+        seed_ = words[2];
+        size_t levels = words[3], bitWords = words[4], leftovers = words[5];
+        size_t rankCount = bitWords / RANK_BLOCK;
+        size_t used = 6 + 2 * levels + bitWords + (rankCount + 1) / 2 + leftovers;
+        if (levels > MAX_LEVELS || bitWords % RANK_BLOCK != 0 || used > count) throw std::invalid_argument("truncated perfect hash function");
+
+        const uint64_t* p = words + 6;
+        levelStart_.resize(levels);
+        levelBits_.resize(levels);
+        for (size_t level = 0; level < levels; ++level) {
+            levelStart_[level] = *p++;
+            levelBits_[level] = *p++;
+        }
+        bits_.assign(p, p + bitWords);
+        p += bitWords;
+        ranks_.resize(rankCount);
+        for (size_t i = 0; i < rankCount; ++i) ranks_[i] = (uint32_t)(p[i / 2] >> (i % 2 * 32));
+        p += (rankCount + 1) / 2;
+        leftover_.assign(p, p + leftovers);
+        return used;
+    }
+
+private:
+    // the hash used at each level, so that keys colliding at one level are
+    // spread out again at the next
+    uint64_t levelHash(uint64_t hash, unsigned int level) const {
+        return hashing::mixInteger(hash ^ (seed_ + (level + 1) * 0x9e3779b97f4a7c15ull));
+    }
+
+    // set bits before bit: the sample for its block plus the block's words up
+    // to bit. Every word of the block is counted, masked, so the loop always
+    // runs the same number of times and its exit is never mispredicted.
+    size_t rank(uint64_t bit) const {
+        size_t word = bit / 64;
+        size_t first = word / RANK_BLOCK * RANK_BLOCK;
+        size_t count = ranks_[word / RANK_BLOCK];
+        for (size_t w = first; w < first + RANK_BLOCK; ++w) {
+            uint64_t mask = w < word ? ~(uint64_t)0 : w == word ? ((uint64_t)1 << (bit % 64)) - 1 : 0;
+            count += perfect_hash::popcount(bits_[w] & mask);
+        }
+        return count;
+    }
+
+    void build(std::vector<uint64_t> hashes, double gamma, unsigned int threads) {
+        if (size_ > UINT32_MAX) throw std::length_error("perfect hash: too many keys");
+        uint64_t start = 0;
+        for (unsigned int level = 0; level < MAX_LEVELS && !hashes.empty(); ++level) {
+            uint64_t words = ((uint64_t)std::ceil(gamma * hashes.size()) + 63) / 64;
+            uint64_t levelBits = words * 64;
+            std::unique_ptr<std::atomic<uint64_t>[]> hit(new std::atomic<uint64_t>[words]);
+            std::unique_ptr<std::atomic<uint64_t>[]> collided(new std::atomic<uint64_t>[words]);
+            for (uint64_t w = 0; w < words; ++w) {
+                hit[w].store(0, std::memory_order_relaxed);
+                collided[w].store(0, std::memory_order_relaxed);
+            }
+
+            // every thread marks the bits its keys hit; a bit already hit is a collision
+            perfect_hash::parallelFor(hashes.size(), threads, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    uint64_t bit = perfect_hash::reduce(levelHash(hashes[i], level), levelBits);
+                    uint64_t mask = (uint64_t)1 << (bit % 64);
+                    if (hit[bit / 64].fetch_or(mask, std::memory_order_relaxed) & mask)
+                        collided[bit / 64].fetch_or(mask, std::memory_order_relaxed);
+                }
+            });
+
+            // keys alone on their bit are placed; the rest move on to the next level
+            size_t first = bits_.size();
+            bits_.resize(first + words);
+            for (uint64_t w = 0; w < words; ++w)
+                bits_[first + w] = hit[w].load(std::memory_order_relaxed) & ~collided[w].load(std::memory_order_relaxed);
+
+            // one slice of the keys per thread, each collecting its own survivors
+            // in order; a level too small to split is one slice
+            size_t slices = hashes.size() < 4096 ? 1 : threads;
+            std::vector<std::vector<uint64_t> > kept(slices);
+            size_t slice = (hashes.size() + slices - 1) / slices;
+            perfect_hash::parallelFor(slices, slices, [&](size_t begin, size_t end) {
+                for (size_t t = begin; t < end; ++t)
+                    for (size_t i = t * slice; i < std::min(hashes.size(), (t + 1) * slice); ++i) {
+                        uint64_t bit = perfect_hash::reduce(levelHash(hashes[i], level), levelBits);
+                        if (collided[bit / 64].load(std::memory_order_relaxed) & ((uint64_t)1 << (bit % 64)))
+                            kept[t].push_back(hashes[i]);
+                    }
+            }, 1);
+            hashes.clear();
+            for (const std::vector<uint64_t>& part : kept) hashes.insert(hashes.end(), part.begin(), part.end());
+
+            levelStart_.push_back(start);
+            levelBits_.push_back(levelBits);
+            start += levelBits;
+        }
+
+        // one rank sample per block, over whole blocks
+        bits_.resize((bits_.size() + RANK_BLOCK - 1) / RANK_BLOCK * RANK_BLOCK, 0);
+        ranks_.assign(bits_.size() / RANK_BLOCK, 0);
+        uint64_t count = 0;
+        for (size_t w = 0; w < bits_.size(); ++w) {
+            if (w % RANK_BLOCK == 0) ranks_[w / RANK_BLOCK] = (uint32_t)count;
+            count += perfect_hash::popcount(bits_[w]);
+        }
+
+        std::sort(hashes.begin(), hashes.end());
+        if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end())
+            throw std::invalid_argument("perfect hash: duplicate keys");
+        leftover_ = std::move(hashes);
+    }
+
+    Hasher hasher_;
+    size_t size_;
+    uint64_t seed_;
+    std::vector<uint64_t> levelStart_;    // first bit of each level in bits_
+    std::vector<uint64_t> levelBits_;     // bits in each level, a multiple of 64
+    std::vector<uint64_t> bits_;          // all levels back to back
+    std::vector<uint32_t> ranks_;         // set bits before each block
+    std::vector<uint64_t> leftover_;      // sorted hashes of keys no level placed
+};
+
+
+// Read-only map from a fixed set of strings to values, built on a
+// MinimalPerfectHash.
+//
+// The function picks the one slot a key can be in, and the slot holds the
+// key's value next to where the key sits in one block of characters, so a
+// lookup is a hash, a rank, one slot and one string compare whether the key
+// is there or not.
+//
+// The whole map serializes to 64-bit words like the function does, so it can
+// be built once by a tool and shipped as a file or as a generated header.
+// Value has to be trivially copyable for that.
+template <class Value, class Hasher = WyHash>
+class StaticHashMap {
+public:
+    static_assert(std::is_trivially_copyable<Value>::value, "StaticHashMap values are stored as raw words");
+
+    StaticHashMap() : slots_(1) {}
+
+    StaticHashMap(const std::vector<std::string>& keys, const std::vector<Value>& values,
+                  double gamma = 1.0, unsigned int threads = std::thread::hardware_concurrency(),
+                  const Hasher& hasher = Hasher())
+        : function_(keys, gamma, threads, hasher), slots_(keys.size() + 1) {
+        if (values.size() != keys.size()) throw std::invalid_argument("StaticHashMap: one value per key");
+        size_t length = 0;
+        for (const std::string& key : keys) length += key.size();
+        if (length > UINT32_MAX) throw std::length_error("StaticHashMap: keys too long");
+
+        // lay the keys out in slot order, so neighbouring slots point at neighbouring keys
+        std::vector<size_t> keyIn(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) keyIn[function_(keys[i])] = i;
+        characters_.reserve(length);
+        for (size_t slot = 0; slot < keys.size(); ++slot) {
+            const std::string& key = keys[keyIn[slot]];
+            slots_[slot].offset = (uint32_t)characters_.size();
+            slots_[slot].value = values[keyIn[slot]];
+            characters_ += key;
+        }
+        slots_.back().offset = (uint32_t)characters_.size();
+    }
+
+    // loads a map written by serialize()
+    StaticHashMap(const uint64_t* words, size_t count, const Hasher& hasher = Hasher())
+        : function_(words, count, hasher) {
+        size_t used = function_.serializedWords();
+        size_t n = function_.size();
+        if (used + 1 > count) throw std::invalid_argument("truncated StaticHashMap");
+        size_t length = words[used++];
+        size_t slotWords = ((n + 1) * sizeof(Slot) + 7) / 8;
+        if (used + slotWords + (length + 7) / 8 > count) throw std::invalid_argument("truncated StaticHashMap");
+
+        slots_.resize(n + 1);
+        std::memcpy(slots_.data(), words + used, (n + 1) * sizeof(Slot));
+        used += slotWords;
+        characters_.assign(reinterpret_cast<const char*>(words + used), length);
+    }
+
+    template <class Q>
+    const Value* search(const Q& key) const {
+        size_t slot = function_(key);
+        if (slot >= size() || keyAt(slot) != std::string_view(key)) return nullptr;
+        return &slots_[slot].value;
+    }
+
+    template <class Q>
+    bool contains(const Q& key) const { return search(key) != nullptr; }
+
+    size_t size() const { return function_.size(); }
+
+    // the key stored in slot, 0..size()-1
+    std::string_view keyAt(size_t slot) const {
+        return std::string_view(characters_.data() + slots_[slot].offset, slots_[slot + 1].offset - slots_[slot].offset);
+    }
+
+    const MinimalPerfectHash<Hasher>& function() const { return function_; }
+
+    std::vector<uint64_t> serialize() const {
+        std::vector<uint64_t> words;
+        function_.serialize(words);
+        words.push_back(characters_.size());
+
+        size_t first = words.size();
+        words.resize(first + (slots_.size() * sizeof(Slot) + 7) / 8, 0);
+        std::memcpy(&words[first], slots_.data(), slots_.size() * sizeof(Slot));
+        first = words.size();
+        words.resize(first + (characters_.size() + 7) / 8, 0);
+        if (!characters_.empty()) std::memcpy(&words[first], characters_.data(), characters_.size());
+        return words;
+    }
+
+private:
+    // a key runs from its slot's offset to the next slot's offset
+    struct Slot {
+        uint32_t offset;
+        Value value;
+    };
+
+    MinimalPerfectHash<Hasher> function_;
+    std::vector<Slot> slots_;    // one per key, and one more holding the end of the last key
+    std::string characters_;    // every key, in slot order
+};
+
+#endif
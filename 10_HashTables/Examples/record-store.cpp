@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include "record-store.h"
+#include "hash-table.h"
+#include "open-addressing.h"
+#include <malloc.h>
+using namespace std;
+
+// One record set, indexed by both idNumber and idName. See record-store.h.
+
+// bytes currently allocated from the heap, including string buffers
+static size_t heapInUse() {
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+
+int main()
+{
+	RecordStore<> h;
+
+	h.insert(1000101, "jacob",  "jacob23@uw.ca");
+	h.insert(2001201, "shawn",  "shawn3@uw.ca");
+	h.insert(3003121, "max",  "maxmax@uw.ca");
+	h.insert(3004578, "grace",  "grace2@uw.ca");
+	h.insert(2001234, "andrew",  "andrew@uw.ca");
+	h.insert(5201863, "peter",  "peterw2@uw.ca");
+	h.insert(3005831, "emily",  "emily3@uw.ca");
+	h.insert(2203234, "mary",  "mary87@uw.ca");
+
+	if ( !h.insert(1000101, "jacob",  "jacob23@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.insert(1000102, "jacob",  "jacob24@uw.ca") )
+		cout << "cannot insert when the same name exists." << endl;
+	if ( !h.removeByName("jack") )
+		cout << "cannot remove when the key does not exist." << endl;
+
+	Record* result = h.findById(2001234);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+	result = h.findByName("grace");
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	// a rename moves the record in the name index only
+	h.update(3003121, "maxine", "maxine@uw.ca");
+	cout<< (h.findByName("max") == NULL ? "max renamed" : "max still there") << endl;
+	result = h.findByName("maxine");
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	// removing by one key removes it from the other index too
+	h.removeById(2001201);
+	cout<< (h.findByName("shawn") == NULL ? "shawn removed" : "shawn still there") << endl;
+
+	// memory for the same records: one store, or the two example tables side by side
+	const int n = 200000;
+	size_t before = heapInUse();
+	{
+		RecordStore<> store;
+		for (int i = 0; i < n; i++)
+			store.insert(i, "member" + to_string(i), "member" + to_string(i) + "@uw.ca");
+		size_t used = heapInUse() - before;
+		cout<< endl << "record store:        " << used / n << " bytes per record" << endl;
+	}
+
+	before = heapInUse();
+	{
+		HashTable<int, Record> byId;
+		RobinHoodHashTable<> byName;
+		for (int i = 0; i < n; i++) {
+			string name = "member" + to_string(i);
+			byId.emplace(i, i, name, name + "@uw.ca");
+			byName.insert(i, name, name + "@uw.ca");
+		}
+		size_t used = heapInUse() - before;
+		cout<< "two separate tables: " << used / n << " bytes per record" << endl;
+	}
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+#ifndef HASH_TABLES_RECORD_STORE_H
+#define HASH_TABLES_RECORD_STORE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "record.h"
+
+// Secondary hash index over a record array.
+//
+// The index stores no keys, only 32-bit slots into the record array, each with
+// the low 32 bits of its key's hash. KeyOf extracts the key from a Record, and
+// the full key comparison reads it straight from the record. Linear probing,
+// deletes shift later entries back (no tombstones), and the entry array
+// doubles at 3/4 full and halves below 1/8.
+//
+// The index never touches records on its own: the owner tells it which slot
+// was added, erased or moved, and it must do so before the record's key changes.
+template <class KeyOf, class Hasher = WyHash>
+class RecordIndex {
+public:
+    static const uint32_t NONE = ~(uint32_t)0;
+    static const uint32_t MIN_CAPACITY = 16;
+
+    explicit RecordIndex(const Hasher& hasher = Hasher())
+        : hasher_(hasher), entries_(MIN_CAPACITY, Entry{0, NONE}), mask_(MIN_CAPACITY - 1), size_(0) {}
+
+    // slot of the record whose key equals key, or NONE
+    template <class Q>
+    uint32_t find(const std::vector<Record>& records, const Q& key) const {
+        uint32_t hash = hashOf(key);
+        for (uint32_t i = hash & mask_; entries_[i].slot != NONE; i = (i + 1) & mask_) {
+            if (entries_[i].hash == hash && keyOf_(records[entries_[i].slot]) == key) return entries_[i].slot;
+        }
+        return NONE;
+    }
+
+    // grows ahead of time, so the following adds cannot fail halfway
+    void reserve(uint32_t count) {
+        uint32_t capacity = entries_.size();
+        while (count > capacity / 4 * 3) capacity *= 2;
+        if (capacity != entries_.size()) rehash(capacity);
+    }
+
+    // indexes records[slot], whose key must not be in the index yet
+    void add(const std::vector<Record>& records, uint32_t slot) {
+        reserve(size_ + 1);
+        uint32_t hash = hashOf(keyOf_(records[slot]));
+        uint32_t i = hash & mask_;
+        while (entries_[i].slot != NONE) i = (i + 1) & mask_;
+        entries_[i] = Entry{hash, slot};
+        size_++;
+    }
+
+    // drops the entry of records[slot]; its key must still be the indexed one
+    void erase(const std::vector<Record>& records, uint32_t slot) {
+        uint32_t i = position(records, slot);
+        entries_[i].slot = NONE;
+        size_--;
+
+        // shift back every following entry that would otherwise be cut off from its home
+        for (uint32_t j = (i + 1) & mask_; entries_[j].slot != NONE; j = (j + 1) & mask_) {
+            uint32_t home = entries_[j].hash & mask_;
+            bool reachable = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (reachable) continue;
+            entries_[i] = entries_[j];
+            entries_[j].slot = NONE;
+            i = j;
+        }
+
+        if (entries_.size() > MIN_CAPACITY && size_ < entries_.size() / 8) rehash(entries_.size() / 2);
+    }
+
+    // the record indexed at from now lives at records[to]
+    void moved(const std::vector<Record>& records, uint32_t from, uint32_t to) {
+        uint32_t hash = hashOf(keyOf_(records[to]));
+        uint32_t i = hash & mask_;
+        while (entries_[i].slot != from) i = (i + 1) & mask_;
+        entries_[i].slot = to;
+    }
+
+    size_t memoryUsage() const { return entries_.capacity() * sizeof(Entry); }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint32_t slot;  // NONE marks an empty entry
+    };
+
+    template <class Q>
+    uint32_t hashOf(const Q& key) const { return (uint32_t)hasher_(key); }
+
+    uint32_t position(const std::vector<Record>& records, uint32_t slot) const {
+        uint32_t i = hashOf(keyOf_(records[slot])) & mask_;
+        while (entries_[i].slot != slot) i = (i + 1) & mask_;
+        return i;
+    }
+
+    // entries carry their hash, so rehashing never reads a record
+    void rehash(uint32_t capacity) {
+        std::vector<Entry> old(capacity, Entry{0, NONE});
+        old.swap(entries_);
+        mask_ = capacity - 1;
+        for (const Entry& entry : old) {
+            if (entry.slot == NONE) continue;
+            uint32_t i = entry.hash & mask_;
+            while (entries_[i].slot != NONE) i = (i + 1) & mask_;
+            entries_[i] = entry;
+        }
+    }
+
+    Hasher hasher_;
+    KeyOf keyOf_;
+    std::vector<Entry> entries_;    // power-of-two size
+    uint32_t mask_;
+    uint32_t size_;
+};
+
+struct IdNumberOf {
+    int operator()(const Record& record) const { return record.idNumber; }
+};
+
+struct IdNameOf {
+    std::string_view operator()(const Record& record) const { return record.idName; }
+};
+
+
+// Club member records stored once, looked up by idNumber or by idName.
+//
+// Records sit in one contiguous array, and each key has a RecordIndex that
+// refers to records by slot. Both keys are unique. Every change goes through
+// the store, which keeps the record array and all indexes in step: a removed
+// record's slot is filled by the last record, and the indexes are repointed.
+// Pointers returned by the find functions are valid until the next insert or
+// remove.
+//
+// To index another field, add a RecordIndex with its own KeyOf and update it
+// wherever byName_ is updated.
+template <class Hasher = WyHash>
+class RecordStore {
+public:
+    explicit RecordStore(const Hasher& hasher = Hasher()) : byId_(hasher), byName_(hasher) {}
+
+    size_t size() const { return records_.size(); }
+
+    Record* findById(int num) {
+        uint32_t slot = byId_.find(records_, num);
+        return slot == NONE ? nullptr : &records_[slot];
+    }
+
+    Record* findByName(std::string_view name) {
+        uint32_t slot = byName_.find(records_, name);
+        return slot == NONE ? nullptr : &records_[slot];
+    }
+
+    // Returns false (and leaves the store unchanged) if either key already exists.
+    bool insert(int num, const std::string& name, const std::string& email) {
+        if (byId_.find(records_, num) != NONE || byName_.find(records_, std::string_view(name)) != NONE)
+            return false;
+
+        byId_.reserve(records_.size() + 1);
+        byName_.reserve(records_.size() + 1);
+        records_.push_back(Record(num, name, email));
+        uint32_t slot = records_.size() - 1;
+        byId_.add(records_, slot);
+        byName_.add(records_, slot);
+        return true;
+    }
+
+    // Changes the name and email of record num. Returns false if there is no
+    // such record, or if another record already has the new name.
+    bool update(int num, const std::string& name, const std::string& email) {
+        uint32_t slot = byId_.find(records_, num);
+        if (slot == NONE) return false;
+
+        Record& record = records_[slot];
+        if (record.idName != name) {
+            if (byName_.find(records_, std::string_view(name)) != NONE) return false;
+            // unindex under the old name before it changes
+            byName_.erase(records_, slot);
+            record.idName = name;
+            byName_.add(records_, slot);
+        }
+        record.emailAddress = email;
+        return true;
+    }
+
+    bool removeById(int num) { return removeSlot(byId_.find(records_, num)); }
+    bool removeByName(std::string_view name) { return removeSlot(byName_.find(records_, name)); }
+
+    // Bytes owned by the store (record array and index arrays), not counting string heap buffers.
+    size_t memoryUsage() const {
+        return records_.capacity() * sizeof(Record) + byId_.memoryUsage() + byName_.memoryUsage();
+    }
+
+private:
+    static const uint32_t NONE = ~(uint32_t)0;
+
+    bool removeSlot(uint32_t slot) {
+        if (slot == NONE) return false;
+
+        byId_.erase(records_, slot);
+        byName_.erase(records_, slot);
+        uint32_t last = records_.size() - 1;
+        if (slot != last) {
+            records_[slot] = std::move(records_[last]);
+            byId_.moved(records_, last, slot);
+            byName_.moved(records_, last, slot);
+        }
+        records_.pop_back();
+        return true;
+    }
+
+    std::vector<Record> records_;
+    RecordIndex<IdNumberOf, Hasher> byId_;
+    RecordIndex<IdNameOf, Hasher> byName_;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef HASH_TABLES_RECORD_H
+#define HASH_TABLES_RECORD_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+// The club member record stored by the example hash tables.
+struct Record {
+    int idNumber;
+    std::string idName;
+    std::string emailAddress;
+    // ... ... other attributes
+
+    Record() : idNumber(0) {}
+    Record(int num, std::string name, std::string email)
+        : idNumber(num), idName(std::move(name)), emailAddress(std::move(email)) {}
+};
+
+// The same record with its strings held elsewhere, e.g. in the string arena
+// of a HashTable (see HashTable::intern). Trivially destructible, so a table
+// of RecordViews frees its nodes without visiting them.
+struct RecordView {
+    int idNumber;
+    std::string_view idName;
+    std::string_view emailAddress;
+
+    RecordView() : idNumber(0) {}
+    RecordView(int num, std::string_view name, std::string_view email)
+        : idNumber(num), idName(name), emailAddress(email) {}
+};
+
+#endif
@@ -1,166 +1,134 @@
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include "hash-table.h"
+#include "record.h"
 using namespace std;
 
-const int CAPACITY = 2000; //in this simple demo, fixed capacity is used.
-
-// declaration and definition
-
-class Node { // the node
-public: 	//set public for simplicity
-      int idNumber;
-      string idName;
-      string emailAddress;
-      // ... ... other attributes
-
-      Node *next;
-
-      Node(int num, string name, string email):  idNumber(num), idName(name), emailAddress(email) , next (NULL) {};
-};
-
-
-class HashTable {
-
-	public:  	//set public for simplicity
-      Node **table;  //to be pointed to the array of linked lists
-
-      //in this simple demo, fixed capacity is used. size of current number of items is not tracked.
-
-      HashTable() {
-            table = new Node*[CAPACITY];
-
-            for (int i = 0; i < CAPACITY; i++)
-                  table[i] = NULL;
-      }
-
-
-      ~HashTable() {
-            for (int i = 0; i < CAPACITY; i++)
-                  if (table[i] != NULL) {
-                        Node *prevNode = NULL;
-                        Node *temp = table[i];
-                        while (temp != NULL) {
-                             prevNode = temp;
-                             temp = temp->next;
-                             delete prevNode;
-                        }
-                  }
-            delete[] table;
-      }
-
-
-	   int hashFunction (int key){
-	   		return key % CAPACITY;
-	   }
-
-
-
-      Node* search(int num) {
-
-            int hashIndex = hashFunction ( num );
-
-            if (table[hashIndex] == NULL)
-                  return NULL;
-            else {
-                  Node *temp = table[hashIndex];
-                  while (temp != NULL && temp->idNumber != num) temp = temp->next;
-                  if (temp == NULL) return NULL;
-                  else              return temp;
-            }
-      }
-
-
-
-      void insert(int num, string name, string email) {
-
-      		if (  search (num) ) {
-      			cout << "cannot insert when the same key exists." << endl;
-      			return;
-			  }
-
-            int hashIndex = hashFunction ( num );
-
-            if (table[hashIndex] == NULL) table[hashIndex] = new Node(num, name, email);
-
-            else {
-                  Node *temp = table[hashIndex];
-                  while (temp->next != NULL) temp = temp->next;
-                  temp->next = new Node(num, name, email);
-            }
-
-        // here could increase size by one and check if size is too large for adjustable capacity.
-		// e.g., when size reaches 75% of capacity, double the capacity.
-      }
-
-      void remove(int num) {
-
-      	    if (  search (num) == NULL ) {
-      			cout << "cannot remove when the key does not exist." << endl;
-      			return;
-			}
-
-            int hashIndex = hashFunction ( num );
-
-            if (table[hashIndex] != NULL) {
-                  Node *prevNode = NULL;
-                  Node *temp = table[hashIndex];
-
-				  // find the target
-                  while (temp->idNumber != num && temp->next != NULL) {
-                        prevNode = temp;
-                        temp = temp->next;
-                  }
-
-                  // temp should be the target now.
-                  if (temp->idNumber == num) {
-                        if (prevNode == NULL) { //it is the first node
-                             Node *nextNode = temp->next;
-                             delete temp;
-                             table[hashIndex] = nextNode;
-                        } else { // it is not the first node
-                             Node *nextNode = temp->next;
-                             delete temp;
-                             prevNode->next = nextNode;
-                        }
-                  }
-                  // else may report error, unexpected cases.
-            }
-
-        // here could do size--, and check if size is too small for adjustable capacity.
-		// e.g., when size is less than 20% of capacity, reduce capacity by half.
-      }
-
-};
-
+// Separate chaining with the generic HashTable from hash-table.h.
+// Records are stored once per node, constructed in place by emplace.
 
 
 int main()
 {
-	HashTable h;
+	HashTable<int, Record> h;
 
-	h.insert(1000101, "jacob",  "jacob23@uw.ca");
-	h.insert(2001201, "shawn",  "shawn3@uw.ca");
-	h.insert(3003121, "max",  "maxmax@uw.ca");
-	h.insert(3004578, "grace",  "grace2@uw.ca");
-	h.insert(2001234, "andrew",  "andrew@uw.ca");
-	h.insert(5201863, "peter",  "peterw2@uw.ca");
-	h.insert(3005831, "emily",  "emily3@uw.ca");
+	h.emplace(1000101, 1000101, "jacob",  "jacob23@uw.ca");
+	h.emplace(2001201, 2001201, "shawn",  "shawn3@uw.ca");
+	h.emplace(3003121, 3003121, "max",  "maxmax@uw.ca");
+	h.emplace(3004578, 3004578, "grace",  "grace2@uw.ca");
+	h.emplace(2001234, 2001234, "andrew",  "andrew@uw.ca");
+	h.emplace(5201863, 5201863, "peter",  "peterw2@uw.ca");
+	h.emplace(3005831, 3005831, "emily",  "emily3@uw.ca");
 
-	Node* result;
+	Record* result;
 
-	h.insert(1000101, "test",  "test@uw.ca");
-	h.remove(123);
+	if ( !h.emplace(1000101, 1000101, "test",  "test@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.remove(123) )
+		cout << "cannot remove when the key does not exist." << endl;
 
 	result = h.search(2001234);
 	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
 
-	h.insert(2203234, "mary",  "mary87@uw.ca");
+	h.insert(2203234, Record(2203234, "mary",  "mary87@uw.ca"));
 
 	result = h.search(2203234);
 	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
 
-	cout<< h.table[1234]->idName << ", "<<  h.table[1234]->next->idName << endl;
+	// insert-or-get: the chain is walked once, whether the key is new or not
+	pair<Record*, bool> slot = h.try_emplace(3003121, 3003121, "maxine", "maxine@uw.ca");
+	cout<< (slot.second ? "inserted " : "already there: ") << slot.first->idName << endl;
+
+	// upsert: overwrite the existing record in place
+	h.insert_or_assign(3003121, Record(3003121, "max",  "max.new@uw.ca"));
+	cout<< h.search(3003121)->emailAddress << endl;
+
+	// keyed on name: lookups by string_view or literal never build a std::string
+	HashTable<string, Record> byName;
+	byName.emplace("jacob", 1000101, "jacob",  "jacob23@uw.ca");
+	byName.emplace("grace", 3004578, "grace",  "grace2@uw.ca");
+
+	string_view wanted = "grace";
+	result = byName.search(wanted);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+	cout<< (byName.contains("jack") ? "jack found" : "jack not found") << endl;
+
+	// grow well past the initial capacity, then shrink back down.
+	HashTable<int, Record> big;
+	for (int i = 0; i < 100000; i++) big.emplace(i, i, "user", "user@uw.ca");
+	cout<< "after 100000 inserts: size " << big.size() << ", capacity " << big.capacity() << endl;
+	for (int i = 0; i < 99000; i++) big.remove(i);
+	cout<< "after 99000 removes: size " << big.size() << ", capacity " << big.capacity() << endl;
+	result = big.search(99999);
+	cout<< result->idNumber << ", "<< result->idName << endl;
+
+	// record strings interned in the table's arena: nodes and strings come
+	// from a few large blocks, and clear() drops them without walking chains
+	HashTable<int, RecordView> views;
+	for (int i = 0; i < 100000; i++) {
+		string name = "user" + to_string(i);
+		views.emplace(i, i, views.intern(name), views.intern(name + "@uw.ca"));
+	}
+	RecordView* view = views.search(4242);
+	cout<< view->idNumber << ", "<< view->idName << ", "<< view->emailAddress << endl;
+	cout<< "100000 record views: " << views.memoryUsage() / 1024 << " KiB owned by the table" << endl;
+	views.clear();
+	cout<< "after clear: size " << views.size() << ", " << views.memoryUsage() << " bytes" << endl;
+
+	// batched lookups on a table far bigger than the caches
+	const int n = 4000000;
+	HashTable<int, int> large;
+	for (int i = 0; i < n; i++) large.emplace(i * 7, i);
+	vector<int> keys;
+	for (int i = 0; i < n; i++) keys.push_back((int)((i * 2654435761u) % n) * 7 + (i % 4 == 0 ? 1 : 0));
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long sum = 0;
+	for (int key : keys) {
+		int* value = large.search(key);
+		if (value != NULL) sum += *value;
+	}
+	double scalar = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	vector<int*> values;
+	large.searchBatch(keys, values);
+	long long batchSum = 0;
+	for (int* value : values)
+		if (value != NULL) batchSum += *value;
+	double batch = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout<< n << " lookups: one at a time " << n / scalar / 1e6 << " M/s, batched " << n / batch / 1e6
+	    << " M/s" << (sum == batchSum ? "" : " (results differ!)") << endl;
+
+	// string keys: hashing and comparing take long enough that a plain loop
+	// no longer overlaps the misses of consecutive lookups
+	const int m = 1000000;
+	HashTable<string, int> names;
+	for (int i = 0; i < m; i++) names.emplace("user" + to_string(i * 7), i);
+	vector<string> nameKeys;
+	for (int i = 0; i < m; i++) nameKeys.push_back("user" + to_string((int)((i * 2654435761u) % m) * 7 + (i % 4 == 0 ? 1 : 0)));
+
+	start = chrono::steady_clock::now();
+	sum = 0;
+	for (const string& key : nameKeys) {
+		int* value = names.search(key);
+		if (value != NULL) sum += *value;
+	}
+	scalar = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	names.searchBatch(nameKeys, values);
+	batchSum = 0;
+	for (int* value : values)
+		if (value != NULL) batchSum += *value;
+	batch = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout<< m << " string lookups: one at a time " << m / scalar / 1e6 << " M/s, batched " << m / batch / 1e6
+	    << " M/s" << (sum == batchSum ? "" : " (results differ!)") << endl;
 
     return 0;
 }
-
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "sharded-hash-table.h"
+#include "concurrent-hash-table.h"
+#include "hash-table.h"
+#include "record.h"
+using namespace std;
+
+// Ingest throughput: every thread inserts its own share of the member
+// records, into one HashTable behind a mutex, into ConcurrentHashTable, and
+// into ShardedHashTable with one shard per thread.
+// See sharded-hash-table.h.
+//
+// usage: sharded-hash-table [maxThreads] [records]
+
+static Record makeRecord(int idNumber) {
+	string name = "member" + to_string(idNumber);
+	return Record(idNumber, name, name + "@uw.ca");
+}
+
+// spreads the ids over the key space so that no thread's share is one shard's
+static int idFor(int i) {
+	return (int)(((uint32_t)i * 2654435761u) & 0x7FFFFFFF);
+}
+
+// runs body(thread) on each of threads threads; returns millions of records per second
+template <class Body>
+double timeThreads(int threads, int records, Body body) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++) workers.push_back(thread(body, t));
+	for (thread& worker : workers) worker.join();
+	return records / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+	int records = argc > 2 ? atoi(argv[2]) : 1000000;
+
+	ShardedHashTable<int, Record> h(2);
+	h.run([](ShardedHashTable<int, Record>::Worker& w) {
+		if (w.shard() == 0) {
+			w.insert_or_assign(1000101, Record(1000101, "jacob",  "jacob23@uw.ca"));
+			w.insert_or_assign(2001201, Record(2001201, "shawn",  "shawn3@uw.ca"));
+		} else {
+			w.insert_or_assign(3003121, Record(3003121, "max",  "maxmax@uw.ca"));
+			w.insert_or_assign(3004578, Record(3004578, "grace",  "grace2@uw.ca"));
+			w.remove(2001201);    // may run before or after shard 0's insert of shawn
+		}
+	});
+	Record* result = h.search(3004578);
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+	cout<< h.size() << " records in " << h.shards() << " shards (" << h.shardTable(0).size() << " + "
+	    << h.shardTable(1).size() << ")" << endl;
+
+	cout << endl << records << " records, " << thread::hardware_concurrency() << " hardware threads" << endl;
+	cout << "million records inserted per second" << endl;
+	cout << setw(8) << "threads" << setw(14) << "one mutex" << setw(14) << "concurrent" << setw(14) << "sharded" << endl;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		int share = records / threads;
+
+		HashTable<int, Record> locked;
+		mutex lock;
+		double lockedRate = timeThreads(threads, share * threads, [&](int t) {
+			for (int i = t * share; i < (t + 1) * share; i++) {
+				Record record = makeRecord(idFor(i));
+				lock_guard<mutex> guard(lock);
+				locked.insert_or_assign(record.idNumber, move(record));
+			}
+		});
+
+		ConcurrentHashTable<int, Record> concurrent;
+		double concurrentRate = timeThreads(threads, share * threads, [&](int t) {
+			for (int i = t * share; i < (t + 1) * share; i++) {
+				Record record = makeRecord(idFor(i));
+				concurrent.insert_or_assign(record.idNumber, move(record));
+			}
+		});
+
+		ShardedHashTable<int, Record> sharded(threads);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		sharded.run([&](ShardedHashTable<int, Record>::Worker& w) {
+			for (int i = (int)w.shard() * share; i < ((int)w.shard() + 1) * share; i++) {
+				Record record = makeRecord(idFor(i));
+				w.insert_or_assign(record.idNumber, move(record));
+			}
+		});
+		double shardedRate = share * threads / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+
+		if (locked.size() != sharded.size() || concurrent.size() != sharded.size())
+			cout << "sizes differ: " << locked.size() << ", " << concurrent.size() << ", " << sharded.size() << endl;
+		cout << setw(8) << threads << fixed << setprecision(2)
+		     << setw(14) << lockedRate << setw(14) << concurrentRate << setw(14) << shardedRate << endl;
+	}
+
+	return 0;
+}
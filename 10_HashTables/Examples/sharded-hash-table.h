@@ -0,0 +1,329 @@
+#ifndef HASH_TABLES_SHARDED_HASH_TABLE_H
+#define HASH_TABLES_SHARDED_HASH_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "hash-functions.h"
+#include "hash-table.h"
+
+// Bounded single-producer, single-consumer ring buffer.
+//
+// One thread pushes and one thread pops, so the two indices need no locks
+// and no read-modify-write instructions: each side owns one index, publishes
+// it with a release store and reads the other side's with an acquire load.
+// Each side also keeps a cached copy of the other's index and only reloads
+// it when the ring looks full (or empty), so a batch costs one store and
+// usually no access to the other side's cache line at all. Slots are raw
+// storage: an item is move-constructed in by push and destroyed once it has
+// been taken, so T need not be default constructible and an empty queue
+// constructs nothing.
+template <class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 1024) : mask_(1) {
+        while (mask_ + 1 < capacity) mask_ = mask_ * 2 + 1;
+        slots_.reset(new Slot[mask_ + 1]);
+        producer_.index.store(0, std::memory_order_relaxed);
+        producer_.otherIndex = 0;
+        consumer_.index.store(0, std::memory_order_relaxed);
+        consumer_.otherIndex = 0;
+    }
+
+    // destroys the items pushed and never consumed
+    ~SpscQueue() {
+        size_t tail = producer_.index.load(std::memory_order_acquire);
+        for (size_t i = consumer_.index.load(std::memory_order_relaxed); i != tail; ++i) at(i).~T();
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Producer: moves as many of items[0..count) in as fit and publishes
+    // them all at once. Returns how many were taken.
+    size_t push(T* items, size_t count) {
+        size_t tail = producer_.index.load(std::memory_order_relaxed);
+        if (tail - producer_.otherIndex + count > capacity())
+            producer_.otherIndex = consumer_.index.load(std::memory_order_acquire);
+        size_t room = capacity() - (tail - producer_.otherIndex);
+        if (count > room) count = room;
+        for (size_t i = 0; i < count; ++i) new (slots_[(tail + i) & mask_].storage) T(std::move(items[i]));
+        producer_.index.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: calls take(T&) on every item available now and destroys it,
+    // then frees their slots at once. Returns how many were taken.
+    template <class Take>
+    size_t consume(Take&& take) {
+        size_t head = consumer_.index.load(std::memory_order_relaxed);
+        if (head == consumer_.otherIndex) {
+            consumer_.otherIndex = producer_.index.load(std::memory_order_acquire);
+            if (head == consumer_.otherIndex) return 0;
+        }
+        size_t tail = consumer_.otherIndex;
+        for (size_t i = head; i != tail; ++i) {
+            take(at(i));
+            at(i).~T();
+        }
+        consumer_.index.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    T& at(size_t i) { return *reinterpret_cast<T*>(slots_[i & mask_].storage); }
+
+    // each side on its own cache line, so the producer publishing never
+    // invalidates the line the consumer is polling, and the other way round
+    struct alignas(64) Side {
+        std::atomic<size_t> index;    // next slot to write (producer) or read (consumer)
+        size_t otherIndex;            // last seen index of the other side
+    };
+
+    Side producer_;
+    Side consumer_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+
+// Hash table split into independent shards, one per worker thread.
+//
+// A key's shard is picked from the high bits of its hash. Each shard is a
+// plain HashTable, with its own node slabs, owned by exactly one worker: only
+// that worker ever touches it, so there are no locks and no shared cache
+// lines on the fast path. A worker applies writes for its own shard
+// directly. Writes for other shards are collected in one local batch per
+// destination and handed over through an SpscQueue per (sender, receiver)
+// pair once BATCH of them have piled up, one release store per batch. Each
+// worker applies what the others sent it whenever it calls poll(), and
+// whenever it is waiting for room in a full queue, so two workers sending to
+// each other cannot deadlock.
+//
+// Writes to other shards are therefore asynchronous: they land after the
+// sender flushes and the receiver polls. Reads go to the local shard only
+// (see Worker::owns). When run() returns the table is quiescent, and any one
+// thread may read all of it through search().
+//
+// Writes are insert_or_assign and remove. For a given key, all writes from
+// one worker are applied in order; writes from different workers to the
+// same key are applied in no particular order. Value has to be default
+// constructible, for the placeholder value a remove carries.
+//
+// A queue holds QUEUE_CAPACITY writes, a few batches: a sender that finds it
+// full polls its own queues until there is room, so a deeper queue would
+// only add memory. It is allocated by the first send from one worker to
+// another, so the shards² queues of a big table only exist for the pairs
+// that actually exchange writes.
+template <class Key, class Value, class Hasher = WyHash>
+class ShardedHashTable {
+    struct Op;
+
+public:
+    static const size_t BATCH = 64;
+    static const size_t QUEUE_CAPACITY = 4 * BATCH;
+
+    // The handle run() gives the thread that owns one shard.
+    class Worker {
+    public:
+        size_t shard() const { return self_; }
+
+        // true if key lives in this worker's shard
+        template <class Q>
+        bool owns(const Q& key) const { return table_.shardOf(table_.hasher_(key)) == self_; }
+
+        template <class K, class V>
+        void insert_or_assign(K&& key, V&& value) {
+            size_t to = table_.shardOf(table_.hasher_(key));
+            if (to == self_) {
+                table_.shards_[self_]->table.insert_or_assign(std::forward<K>(key), std::forward<V>(value));
+            } else {
+                route(to, Op(Op::ASSIGN, std::forward<K>(key), std::forward<V>(value)));
+            }
+        }
+
+        template <class K>
+        void remove(K&& key) {
+            size_t to = table_.shardOf(table_.hasher_(key));
+            if (to == self_) {
+                table_.shards_[self_]->table.remove(key);
+            } else {
+                route(to, Op(Op::REMOVE, std::forward<K>(key), Value()));
+            }
+        }
+
+        // Looks key up in this worker's shard. A key owned by another shard
+        // is not found here; see owns().
+        template <class Q>
+        Value* searchLocal(const Q& key) {
+            return table_.shards_[self_]->table.search(key);
+        }
+
+        // Applies every write the other workers have handed over so far.
+        // Returns how many were applied.
+        size_t poll() {
+            size_t applied = 0;
+            HashTable<Key, Value, Hasher>& local = table_.shards_[self_]->table;
+            for (size_t from = 0; from < table_.shards_.size(); ++from) {
+                if (from == self_) continue;
+                SpscQueue<Op>* incoming = table_.queue(from, self_).load(std::memory_order_acquire);
+                if (incoming == nullptr) continue;
+                applied += incoming->consume([&local](Op& op) {
+                    if (op.kind == Op::ASSIGN) local.insert_or_assign(std::move(op.key), std::move(op.value));
+                    else local.remove(op.key);
+                });
+            }
+            return applied;
+        }
+
+        // hands every partly filled batch over to its shard
+        void flush() {
+            for (size_t to = 0; to < pending_.size(); ++to) send(to);
+        }
+
+    private:
+        friend class ShardedHashTable;
+
+        // Flushes, then keeps applying incoming writes until every worker
+        // has finished and nothing is left in flight.
+        void finish() {
+            flush();
+            table_.finished_.fetch_add(1, std::memory_order_acq_rel);
+            while (table_.finished_.load(std::memory_order_acquire) < table_.shards_.size()) {
+                if (poll() == 0) std::this_thread::yield();
+            }
+            // every other worker's last batch was published before it finished
+            poll();
+        }
+
+        Worker(ShardedHashTable& table, size_t self) : table_(table), self_(self), pending_(table.shards_.size()) {}
+
+        void route(size_t to, Op&& op) {
+            // a batch is only reserved once it is used, like its queue
+            if (pending_[to].capacity() == 0) pending_[to].reserve(BATCH);
+            pending_[to].push_back(std::move(op));
+            if (pending_[to].size() == BATCH) send(to);
+        }
+
+        // pushes the batch for shard to, working through incoming writes
+        // while the queue is full
+        void send(size_t to) {
+            std::vector<Op>& batch = pending_[to];
+            if (batch.empty()) return;
+            // only this worker ever stores to its outgoing queues
+            std::atomic<SpscQueue<Op>*>& slot = table_.queue(self_, to);
+            SpscQueue<Op>* outgoing = slot.load(std::memory_order_relaxed);
+            if (outgoing == nullptr) {
+                outgoing = new SpscQueue<Op>(QUEUE_CAPACITY);
+                slot.store(outgoing, std::memory_order_release);
+            }
+            size_t sent = 0;
+            while (sent < batch.size()) {
+                sent += outgoing->push(batch.data() + sent, batch.size() - sent);
+                if (sent < batch.size() && poll() == 0) std::this_thread::yield();
+            }
+            batch.clear();
+        }
+
+        ShardedHashTable& table_;
+        size_t self_;
+        std::vector<std::vector<Op> > pending_;    // per destination shard
+    };
+
+    // shards defaults to one per hardware thread
+    explicit ShardedHashTable(size_t shards = std::thread::hardware_concurrency(), const Hasher& hasher = Hasher())
+        : hasher_(hasher), finished_(0) {
+        if (shards < 1) shards = 1;
+        for (size_t i = 0; i < shards; ++i) shards_.emplace_back(new Shard(hasher));
+        queues_.reset(new std::atomic<SpscQueue<Op>*>[shards * shards]);
+        for (size_t i = 0; i < shards * shards; ++i) queues_[i].store(nullptr, std::memory_order_relaxed);
+        for (size_t i = 0; i < shards; ++i) workers_.emplace_back(new Worker(*this, i));
+    }
+
+    ~ShardedHashTable() {
+        for (size_t i = 0; i < shards_.size() * shards_.size(); ++i) delete queues_[i].load(std::memory_order_relaxed);
+    }
+
+    ShardedHashTable(const ShardedHashTable&) = delete;
+    ShardedHashTable& operator=(const ShardedHashTable&) = delete;
+
+    size_t shards() const { return shards_.size(); }
+
+    // Runs body(Worker&) on one thread per shard, then finishes every worker.
+    // Returns when all writes have been applied.
+    template <class Body>
+    void run(Body&& body) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < shards_.size(); ++i)
+            threads.emplace_back([this, i, &body]() {
+                body(*workers_[i]);
+                workers_[i]->finish();
+            });
+        for (std::thread& thread : threads) thread.join();
+        finished_.store(0, std::memory_order_relaxed);
+    }
+
+    // Only while no worker is running.
+    template <class Q>
+    Value* search(const Q& key) {
+        return shards_[shardOf(hasher_(key))]->table.search(key);
+    }
+
+    // Only while no worker is running.
+    size_t size() const {
+        size_t total = 0;
+        for (const std::unique_ptr<Shard>& shard : shards_) total += shard->table.size();
+        return total;
+    }
+
+    const HashTable<Key, Value, Hasher>& shardTable(size_t i) const { return shards_[i]->table; }
+
+private:
+    struct Op {
+        enum Kind { ASSIGN, REMOVE };
+
+        Kind kind;
+        Key key;
+        Value value;
+
+        template <class K, class V>
+        Op(Kind k, K&& ky, V&& v) : kind(k), key(std::forward<K>(ky)), value(std::forward<V>(v)) {}
+    };
+
+    // a shard on its own cache lines, so neighbouring shards' table headers
+    // are not falsely shared
+    struct alignas(64) Shard {
+        HashTable<Key, Value, Hasher> table;
+
+        explicit Shard(const Hasher& hasher) : table(hasher) {}
+    };
+
+    // the high half of the hash picks the shard; HashTable buckets use the low bits
+    size_t shardOf(uint64_t hash) const {
+        return (size_t)(((hash >> 32) * (uint64_t)shards_.size()) >> 32);
+    }
+
+    // null until from first sends to to
+    std::atomic<SpscQueue<Op>*>& queue(size_t from, size_t to) { return queues_[from * shards_.size() + to]; }
+
+    Hasher hasher_;
+    std::vector<std::unique_ptr<Shard> > shards_;
+    std::unique_ptr<std::atomic<SpscQueue<Op>*>[]> queues_;    // [from][to], flattened
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::atomic<size_t> finished_;    // workers done sending in the current run
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef HASH_TABLES_SLAB_ALLOCATOR_H
+#define HASH_TABLES_SLAB_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// Fixed-size slot allocator for hash table nodes.
+//
+// Slots are carved out of large slabs instead of asking the heap for every
+// node. A freed slot is pushed onto an intrusive free list (the list pointer
+// is stored inside the dead slot itself) and handed out again by the next
+// allocate, so a table that keeps inserting and removing stops touching the
+// heap entirely once it reaches its working size. Nodes allocated one after
+// another sit next to each other in memory.
+//
+// The allocator only hands out raw memory: the owner constructs and destroys
+// objects in it. release() drops whole slabs at once, so owners whose nodes
+// are trivially destructible never have to visit them one by one.
+template <class T>
+class NodeSlab {
+public:
+    static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+    NodeSlab() : freeList_(nullptr), next_(nullptr), end_(nullptr) {}
+    ~NodeSlab() { release(); }
+
+    NodeSlab(const NodeSlab&) = delete;
+    NodeSlab& operator=(const NodeSlab&) = delete;
+
+    // memory for one T, not constructed
+    void* allocate() {
+        if (freeList_ != nullptr) {
+            FreeSlot* slot = freeList_;
+            freeList_ = slot->next;
+            return slot;
+        }
+        if (next_ == end_) addSlab();
+        void* slot = next_;
+        next_ += SLOT_SIZE;
+        return slot;
+    }
+
+    // slot must come from this allocator and its object must already be destroyed
+    void deallocate(void* p) {
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = freeList_;
+        freeList_ = slot;
+    }
+
+    // frees every slab; all slots become invalid
+    void release() {
+        for (char* slab : slabs_) ::operator delete(slab);
+        slabs_.clear();
+        freeList_ = nullptr;
+        next_ = end_ = nullptr;
+    }
+
+    size_t memoryUsage() const { return slabs_.size() * SLAB_BYTES; }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static constexpr size_t ALIGN = alignof(T) > alignof(FreeSlot) ? alignof(T) : alignof(FreeSlot);
+    static constexpr size_t RAW_SIZE = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot);
+    static constexpr size_t SLOT_SIZE = (RAW_SIZE + ALIGN - 1) / ALIGN * ALIGN;
+    static_assert(SLOT_SIZE <= SLAB_BYTES, "node does not fit in a slab");
+
+    void addSlab() {
+        // operator new memory is aligned for any fundamental type
+        char* slab = static_cast<char*>(::operator new(SLAB_BYTES));
+        slabs_.push_back(slab);
+        next_ = slab;
+        end_ = slab + SLAB_BYTES / SLOT_SIZE * SLOT_SIZE;
+    }
+
+    FreeSlot* freeList_;
+    std::vector<char*> slabs_;
+    char* next_;    // next never-used slot in the newest slab
+    char* end_;
+};
+
+
+// Bump allocator for string bytes owned by a table.
+//
+// intern copies a string into the current block and returns a view of the
+// copy. Nothing is freed one string at a time: bytes of removed records stay
+// in their block until release() drops all blocks together.
+class StringArena {
+public:
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+    StringArena() : next_(nullptr), end_(nullptr), bytesUsed_(0), bytesReserved_(0) {}
+    ~StringArena() { release(); }
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    std::string_view intern(std::string_view str) {
+        if (str.empty()) return std::string_view();
+        if ((size_t)(end_ - next_) < str.size()) addBlock(str.size());
+
+        char* copy = next_;
+        std::memcpy(copy, str.data(), str.size());
+        next_ += str.size();
+        bytesUsed_ += str.size();
+        return std::string_view(copy, str.size());
+    }
+
+    void release() {
+        for (char* block : blocks_) ::operator delete(block);
+        blocks_.clear();
+        next_ = end_ = nullptr;
+        bytesUsed_ = bytesReserved_ = 0;
+    }
+
+    size_t bytesUsed() const { return bytesUsed_; }
+    size_t memoryUsage() const { return bytesReserved_; }
+
+private:
+    // strings longer than a block get a block of their own
+    void addBlock(size_t atLeast) {
+        size_t bytes = std::max(atLeast, BLOCK_BYTES);
+        char* block = static_cast<char*>(::operator new(bytes));
+        blocks_.push_back(block);
+        next_ = block;
+        end_ = block + bytes;
+        bytesReserved_ += bytes;
+    }
+
+    std::vector<char*> blocks_;
+    char* next_;
+    char* end_;
+    size_t bytesUsed_;
+    size_t bytesReserved_;
+};
+
+#endif
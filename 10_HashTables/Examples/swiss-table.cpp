@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "swiss-table.h"
+#include "open-addressing.h"
+using namespace std;
+
+// Records are keyed on idName. See swiss-table.h for the control byte layout.
+
+// times n lookups of keys that are not in the table
+template <class Table>
+double timeMisses(Table& table, const vector<string>& missing) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int found = 0;
+	for (const string& name : missing)
+		if (table.search(name) != NULL) found++;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	if (found != 0) cout << "unexpected hits: " << found << endl;
+	return missing.size() / seconds / 1e6;
+}
+
+
+int main()
+{
+	SwissHashTable<> h;
+
+	h.insert(1000101, "jacob",  "jacob23@uw.ca");
+	h.insert(2001201, "shawn",  "shawn3@uw.ca");
+	h.insert(3003121, "max",  "maxmax@uw.ca");
+	h.insert(3004578, "grace",  "grace2@uw.ca");
+	h.insert(2001234, "andrew",  "andrew@uw.ca");
+	h.insert(5201863, "peter",  "peterw2@uw.ca");
+	h.insert(3005831, "emily",  "emily3@uw.ca");
+	h.insert(2203234, "mary",  "mary87@uw.ca");
+
+	if ( !h.insert(1000101, "jacob",  "jacob23@uw.ca") )
+		cout << "cannot insert when the same key exists." << endl;
+	if ( !h.remove("jack") )
+		cout << "cannot remove when the key does not exist." << endl;
+
+	Record* result;
+	result = h.search("grace");
+	cout<< result->idNumber << ", "<< result->idName << ", "<<  result->emailAddress << endl;
+
+	h.remove("grace");
+	cout<< (h.search("grace") == NULL ? "grace removed" : "grace still there") << endl;
+
+	// miss-heavy lookups: the swiss table rejects most misses with one group compare
+	const int N = 200000;
+	SwissHashTable<> swiss;
+	RobinHoodHashTable<> robin;
+	vector<string> missing;
+	for (int i = 0; i < N; i++) {
+		swiss.insert(i, "user" + to_string(i), "user@uw.ca");
+		robin.insert(i, "user" + to_string(i), "user@uw.ca");
+		missing.push_back("nobody" + to_string(i));
+	}
+	cout<< "size " << swiss.size() << ", capacity " << swiss.capacity() << endl;
+	cout<< "missing lookups, swiss table: " << timeMisses(swiss, missing) << " M/s" << endl;
+	cout<< "missing lookups, robin hood:  " << timeMisses(robin, missing) << " M/s" << endl;
+
+    return 0;
+}
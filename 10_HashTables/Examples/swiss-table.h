@@ -0,0 +1,234 @@
+#ifndef HASH_TABLES_SWISS_TABLE_H
+#define HASH_TABLES_SWISS_TABLE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include "hash-functions.h"
+#include "record.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Open addressing hash table keyed on idName, probed with SwissTable-style
+// control bytes.
+//
+// Next to the flat record array there is one control byte per slot:
+//   EMPTY   (0x80)  slot never used since the last rehash
+//   DELETED (0xFE)  tombstone left by remove
+//   0..127          slot is full, low 7 bits of the key's hash (H2)
+//
+// Slots are probed in groups of 16. One SSE2 compare + movemask turns a group
+// of control bytes into a 16-bit mask of slots whose H2 matches, and full key
+// comparisons only happen for those. A group containing an EMPTY byte ends the
+// probe, so a miss usually costs a single group compare and no string compare.
+//
+// Hasher is a policy from hash-functions.h.
+template <class Hasher = WyHash>
+class SwissHashTable {
+public:
+    static const unsigned int GROUP_WIDTH = 16;
+    static const unsigned int MIN_CAPACITY = 16;
+
+    explicit SwissHashTable(unsigned int initialCapacity = MIN_CAPACITY, const Hasher& hasher = Hasher())
+        : hasher_(hasher), records_(nullptr), ctrl_(nullptr), capacity_(0), size_(0), tombstones_(0) {
+        unsigned int cap = MIN_CAPACITY;
+        while (cap < initialCapacity) cap *= 2;
+        allocate(cap);
+    }
+
+    ~SwissHashTable() {
+        destroyRecords();
+        release();
+    }
+
+    SwissHashTable(const SwissHashTable&) = delete;
+    SwissHashTable& operator=(const SwissHashTable&) = delete;
+
+    unsigned int size() const { return size_; }
+    unsigned int capacity() const { return capacity_; }
+
+    // The high bits pick the group and the low 7 bits become the control byte,
+    // so the hasher must mix well across all 64 bits.
+    uint64_t hashString(const std::string& str) const {
+        return hasher_(str);
+    }
+
+    Record* search(const std::string& name) {
+        uint64_t hash = hashString(name);
+        int slot = findSlot(name, hash);
+        return slot < 0 ? nullptr : &records_[slot];
+    }
+
+    // Returns false (and leaves the table unchanged) if the key already exists.
+    // The duplicate check and the search for a free slot share one probe.
+    bool insert(int num, const std::string& name, const std::string& email) {
+        uint64_t hash = hashString(name);
+        int target = -1;
+        if (findSlot(name, hash, &target) >= 0) return false;
+
+        if ((size_ + tombstones_ + 1) * 8 > capacity_ * 7) {
+            // mostly tombstones: rehash in place size, otherwise grow
+            rehash(size_ * 2 < capacity_ ? capacity_ : capacity_ * 2);
+            findSlot(name, hash, &target);
+        }
+
+        if (ctrl_[target] == DELETED) tombstones_--;
+        new (&records_[target]) Record(num, name, email);
+        ctrl_[target] = h2(hash);
+        size_++;
+        return true;
+    }
+
+    // Returns false if the key does not exist.
+    bool remove(const std::string& name) {
+        int slot = findSlot(name, hashString(name));
+        if (slot < 0) return false;
+
+        records_[slot].~Record();
+        // if the group still has an EMPTY byte no probe sequence ever continued
+        // past it, so the slot can go straight back to EMPTY instead of a tombstone
+        if (matchEmpty(&ctrl_[slot & ~(GROUP_WIDTH - 1)]) != 0) {
+            ctrl_[slot] = EMPTY;
+        } else {
+            ctrl_[slot] = DELETED;
+            tombstones_++;
+        }
+        size_--;
+        return true;
+    }
+
+    // Bytes owned by the table itself (slot arrays), not counting string heap buffers.
+    size_t memoryUsage() const {
+        return (size_t)capacity_ * (sizeof(Record) + 1);
+    }
+
+private:
+    static const int8_t EMPTY = (int8_t)0x80;
+    static const int8_t DELETED = (int8_t)0xFE;
+
+    static int8_t h2(uint64_t hash) { return (int8_t)(hash & 0x7F); }
+    static uint64_t h1(uint64_t hash) { return hash >> 7; }
+
+#ifdef __SSE2__
+    // bit i set if control byte i of the group equals b
+    static uint32_t match(const int8_t* group, int8_t b) {
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(b)));
+    }
+
+    static uint32_t matchEmpty(const int8_t* group) {
+        return match(group, EMPTY);
+    }
+
+    // EMPTY and DELETED are the only control bytes with the sign bit set
+    static uint32_t matchEmptyOrDeleted(const int8_t* group) {
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return (uint32_t)_mm_movemask_epi8(ctrl);
+    }
+#else
+    static uint32_t match(const int8_t* group, int8_t b) {
+        uint32_t mask = 0;
+        for (unsigned int i = 0; i < GROUP_WIDTH; ++i) {
+            if (group[i] == b) mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    static uint32_t matchEmpty(const int8_t* group) {
+        return match(group, EMPTY);
+    }
+
+    static uint32_t matchEmptyOrDeleted(const int8_t* group) {
+        uint32_t mask = 0;
+        for (unsigned int i = 0; i < GROUP_WIDTH; ++i) {
+            if (group[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+    }
+#endif
+
+    static unsigned int lowestBit(uint32_t mask) {
+        return (unsigned int)__builtin_ctz(mask);
+    }
+
+    // Probes group by group (triangular steps, which visit every group of a
+    // power-of-two table). Returns the slot holding name, or -1. If freeSlot is
+    // given it receives the first EMPTY or DELETED slot on the probe sequence.
+    int findSlot(const std::string& name, uint64_t hash, int* freeSlot = nullptr) const {
+        unsigned int numGroups = capacity_ / GROUP_WIDTH;
+        unsigned int group = h1(hash) & (numGroups - 1);
+        int8_t tag = h2(hash);
+        if (freeSlot != nullptr) *freeSlot = -1;
+
+        for (unsigned int step = 1; step <= numGroups; ++step) {
+            const int8_t* ctrl = &ctrl_[group * GROUP_WIDTH];
+
+            for (uint32_t candidates = match(ctrl, tag); candidates != 0; candidates &= candidates - 1) {
+                unsigned int slot = group * GROUP_WIDTH + lowestBit(candidates);
+                if (records_[slot].idName == name) return (int)slot;
+            }
+
+            if (freeSlot != nullptr && *freeSlot < 0) {
+                uint32_t available = matchEmptyOrDeleted(ctrl);
+                if (available != 0) *freeSlot = (int)(group * GROUP_WIDTH + lowestBit(available));
+            }
+            if (matchEmpty(ctrl) != 0) return -1;
+            group = (group + step) & (numGroups - 1);
+        }
+        return -1;
+    }
+
+    void rehash(unsigned int newCapacity) {
+        Record* oldRecords = records_;
+        int8_t* oldCtrl = ctrl_;
+        unsigned int oldCapacity = capacity_;
+
+        allocate(newCapacity);
+        for (unsigned int i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            uint64_t hash = hashString(oldRecords[i].idName);
+            int target;
+            findSlot(oldRecords[i].idName, hash, &target);
+            new (&records_[target]) Record(std::move(oldRecords[i]));
+            ctrl_[target] = h2(hash);
+            oldRecords[i].~Record();
+        }
+        tombstones_ = 0;
+        std::free(oldRecords);
+        std::free(oldCtrl);
+    }
+
+    void allocate(unsigned int cap) {
+        records_ = static_cast<Record*>(std::malloc((size_t)cap * sizeof(Record)));
+        // groups are loaded with aligned SSE2 loads
+        ctrl_ = static_cast<int8_t*>(aligned_alloc(GROUP_WIDTH, cap));
+        if (records_ == nullptr || ctrl_ == nullptr) throw std::bad_alloc();
+        std::memset(ctrl_, EMPTY, cap);
+        capacity_ = cap;
+    }
+
+    void destroyRecords() {
+        for (unsigned int i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0) records_[i].~Record();
+        }
+    }
+
+    void release() {
+        std::free(records_);
+        std::free(ctrl_);
+    }
+
+    Hasher hasher_;
+    Record* records_;       // constructed only where the control byte is full
+    int8_t* ctrl_;          // one control byte per slot
+    unsigned int capacity_; // power of two, at least GROUP_WIDTH
+    unsigned int size_;
+    unsigned int tombstones_;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "doubly-linked-list.h"
+#include <type_traits>
 
 DoublyLinkedList::Node::Node(DataType data) 
     : value(data), prev(nullptr), next(nullptr) {}
@@ -7,12 +8,9 @@ DoublyLinkedList::DoublyLinkedList()
     : head_(nullptr), tail_(nullptr), size_(0) {}
 
 DoublyLinkedList::~DoublyLinkedList() {
-    Node* current = head_;
-    while (current != nullptr) {
-        Node* next = current->next;
-        delete current;
-        current = next;
-    }
+    // Nodes hold nothing to free, so the pool frees them all at once when
+    // it is destroyed, without walking the list.
+    static_assert(std::is_trivially_destructible<Node>::value, "nodes are freed without being destroyed");
     head_ = tail_ = nullptr;
 }
 
@@ -37,6 +35,11 @@ bool DoublyLinkedList::full() const {
 }
 
 
+const NodePoolStats& DoublyLinkedList::pool_stats() const {
+    return pool_.stats();
+}
+
+
 DoublyLinkedList::DataType DoublyLinkedList::select(unsigned int index) const {
     // Check if the list is empty
     if (size_ == 0) return DataType(-999);  // List is empty, return sentinel value
@@ -126,7 +129,7 @@ bool DoublyLinkedList::insert(DataType value, unsigned int index) {
     // Index out of bounds or list at capacity
     if (index > size_ || size_ >= CAPACITY) return false;
 
-    Node* newNode = new Node(value);
+    Node* newNode = pool_.create(value);
 
     // Inserting into an empty list
     if (head_ == nullptr) {
@@ -175,26 +178,26 @@ bool DoublyLinkedList::remove(unsigned int index) {
     Node* toDelete = getNode(index);
     // Removing the only node in the list
     if (size_ == 1) {
-        delete head_;
+        pool_.destroy(head_);
         head_ = tail_ = nullptr;
     }
     // Removing the head node
     else if (index == 0) {
         head_ = head_->next;
         head_->prev = nullptr;  // Set new head's prev to nullptr
-        delete toDelete;
+        pool_.destroy(toDelete);
     }
     // Removing the tail node
     else if(index == size_ - 1) {
         tail_ = tail_->prev;
         tail_->next = nullptr;  // Set new tail's next to nullptr
-        delete toDelete;
+        pool_.destroy(toDelete);
     }
     // Removing a middle node
     else {
         toDelete->prev->next = toDelete->next;
         toDelete->next->prev = toDelete->prev;
-        delete toDelete;
+        pool_.destroy(toDelete);
     }
     size_--;
     return true;
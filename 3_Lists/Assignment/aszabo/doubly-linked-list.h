@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <limits.h>
+#include "node-pool.h"
 
 class DoublyLinkedList {
 public:
@@ -36,6 +37,10 @@ private:
 
 
 	// MEMBER VARIABLES
+    // Where the nodes are allocated from. Declared first, so it is
+    // destroyed last.
+    NodePool<Node> pool_;
+
     // A pointer to the head node of the list.
     Node* head_;
 
@@ -75,6 +80,9 @@ public:
     // Returns true if the list is at capacity, false otherwise.
     bool full() const;
 
+    // Returns what the node pool has allocated so far.
+    const NodePoolStats& pool_stats() const;
+
     // Returns the value at the given index in the list. If index is invalid, 
     // return the value of the last element.
     DataType select(unsigned int index) const;
@@ -0,0 +1,147 @@
+#ifndef LAB1_NODE_POOL_H
+#define LAB1_NODE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// What a NodePool has allocated so far.
+struct NodePoolStats {
+    // Chunks taken from the heap, and their total size in bytes.
+    unsigned long long chunks;
+    unsigned long long bytes;
+
+    // Nodes created and not yet destroyed.
+    unsigned long long live;
+
+    // Nodes created in a slot that an earlier node was destroyed in.
+    unsigned long long reused;
+};
+
+
+// Allocates nodes of type T for a linked container, in place of new and
+// delete on every node.
+//
+// Nodes come from chunks taken from the heap: 4 KiB first, then doubling up
+// to 64 KiB, so a small list stays small and nodes created one after another
+// sit next to each other in memory. A destroyed node's slot goes on a free
+// list that is threaded through the slots themselves, and the next node
+// created takes the slot destroyed last, which is still in the cache.
+// Memory goes back to the heap only when the pool is destroyed. Slots are
+// aligned as T asks, also beyond what malloc guarantees, so a T declared
+// alignas(64) starts on a cache line.
+template <class T>
+class NodePool {
+public:
+    static const std::size_t FIRST_CHUNK_BYTES = 4096;
+    static const std::size_t MAX_CHUNK_BYTES = 64 * 1024;
+
+    NodePool() : chunks_(nullptr), free_(nullptr), next_(nullptr), end_(nullptr),
+                 chunkBytes_(FIRST_CHUNK_BYTES) {
+        stats_.chunks = 0;
+        stats_.bytes = 0;
+        stats_.live = 0;
+        stats_.reused = 0;
+    }
+
+    // Frees every chunk. Nodes still live are not destroyed, so T has to be
+    // trivially destructible or the owner destroys them first.
+    ~NodePool() {
+        while (chunks_ != nullptr) {
+            Chunk* prev = chunks_->prev;
+            std::free(chunks_);
+            chunks_ = prev;
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Constructs a T from args in a free slot.
+    template <class... Args>
+    T* create(Args&&... args) {
+        Slot* slot = take();
+        try {
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            give(slot);
+            throw;
+        }
+    }
+
+    // Destroys a node made by create and frees its slot.
+    void destroy(T* node) {
+        node->~T();
+        give(reinterpret_cast<Slot*>(node));
+    }
+
+    const NodePoolStats& stats() const { return stats_; }
+
+private:
+    union Slot {
+        Slot* next;    // while on the free list
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // starts each chunk, followed by its slots
+    struct Chunk {
+        Chunk* prev;
+    };
+
+    Slot* take() {
+        Slot* slot;
+        if (free_ != nullptr) {
+            slot = free_;
+            free_ = free_->next;
+            stats_.reused++;
+        } else {
+            if (next_ == end_) grow();
+            slot = next_++;
+        }
+        stats_.live++;
+        return slot;
+    }
+
+    void give(Slot* slot) {
+        slot->next = free_;
+        free_ = slot;
+        stats_.live--;
+    }
+
+    // Starts a new chunk; its slots are handed out in order from next_.
+    void grow() {
+        void* block = std::malloc(chunkBytes_);
+        if (block == nullptr) throw std::bad_alloc();
+
+        Chunk* chunk = static_cast<Chunk*>(block);
+        chunk->prev = chunks_;
+        chunks_ = chunk;
+        // the first slot goes at the first aligned address after the header
+        std::uintptr_t first = reinterpret_cast<std::uintptr_t>(chunk + 1);
+        first = (first + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        std::size_t used = first - reinterpret_cast<std::uintptr_t>(block);
+        next_ = reinterpret_cast<Slot*>(first);
+        end_ = next_ + (chunkBytes_ - used) / sizeof(Slot);
+
+        stats_.chunks++;
+        stats_.bytes += chunkBytes_;
+        if (chunkBytes_ < MAX_CHUNK_BYTES) chunkBytes_ *= 2;
+    }
+
+    Chunk* chunks_;           // the newest chunk
+    Slot* free_;              // the slot destroyed last
+    Slot* next_;              // never used slots of the newest chunk
+    Slot* end_;
+    std::size_t chunkBytes_;  // size of the next chunk
+    NodePoolStats stats_;
+};
+
+template <class T>
+const std::size_t NodePool<T>::FIRST_CHUNK_BYTES;
+
+template <class T>
+const std::size_t NodePool<T>::MAX_CHUNK_BYTES;
+
+#endif
@@ -1,22 +1,53 @@
 #ifndef LAB1_SEQUENTIAL_LIST_H
 #define LAB1_SEQUENTIAL_LIST_H
 
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "capacity-policy.h"
+#include "simd-scan.h"
+
+// A dynamic array of T that keeps its elements in insertion order.
+//
+// Elements live in one malloc'd block. Inserting or removing in the middle
+// shifts the elements after it by one; growing doubles the block and moving
+// the elements to it is a relocation. For trivially copyable T (ints,
+// pointers, plain structs) both are done in bulk: shifts with memmove and
+// growth with realloc, which can often extend the block in place. Other
+// types are moved one by one, never copied, so a list of strings shifts
+// pointers, not characters. When to grow and shrink is up to a
+// CapacityPolicy, which also counts the reallocations.
+//
+// Scans over the whole list (search, count, min, max and the range queries)
+// are plain loops, except for lists of int: those use the SSE4.1 or AVX2
+// kernels of simd-scan.h, whichever the CPU has.
+template <class T>
 class SequentialList {
 public:
-	// Can be seen outside as SequentialList::DataType
-	typedef int DataType;	
+	// Can be seen outside as SequentialList<T>::DataType
+	typedef T DataType;
 
 
-private:	
+private:
 	// Befriend so tests have access to variables.
 	friend class SequentialListTest;
 
+	// The smallest capacity a list is created or shrunk to.
+	static const unsigned int MIN_CAPACITY = 20;
+
+	// True if elements can be shifted and relocated as raw bytes.
+	static const bool TRIVIAL = std::is_trivially_copyable<DataType>::value;
+
 
 	// MEMBER VARIABLES
-	// A pointer to the block of memory allocated to store the list data.
-	DataType *data_;
+	// When to grow and shrink, and what it has cost.
+	CapacityPolicy policy_;
 
 	// The capacity of the list
 	// (i.e., the maximum number of items the list can store).
@@ -25,22 +56,57 @@ private:
 	// The number of used elements in data_.
 	unsigned int size_;
 
+	// A pointer to the block of memory allocated to store the list data.
+	// Only the first size_ elements are constructed.
+	DataType *data_;
+
+
+	// The smallest capacity: MIN_CAPACITY or the policy's minimum.
+	unsigned int minCapacity() const { return policy_.floor(MIN_CAPACITY); }
+
+	// Allocates room for cap elements, throwing std::bad_alloc on failure.
+	static DataType* allocate(unsigned int cap);
+
+	// Moves the elements to a block of the given capacity.
+	void relocate(unsigned int cap);
+
+	// Makes room for at least needed elements, growing the capacity by the
+	// policy's factor as many times as that takes but reallocating once.
+	void growFor(unsigned int needed);
+
+	// Opens a gap of count unconstructed slots at index by moving the
+	// elements after it count places to the right, in one pass.
+	void openGap(unsigned int index, unsigned int count);
 
-	// Copy constructor. Declared private so we don't use it incorrectly.
-	SequentialList(const SequentialList& rhs) {}
+	// Undoes openGap: moves the elements after the gap back to index.
+	void closeGap(unsigned int index, unsigned int count);
 
-	// Assignment operator. Declared private so we don't use it incorrectly.
-	SequentialList& operator=(const SequentialList& rhs) {}
+	template <class InputIt>
+	bool append_range(InputIt first, InputIt last, std::input_iterator_tag);
+	template <class ForwardIt>
+	bool append_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+	// Destroys every element, leaving the block allocated.
+	void destroyAll();
 
 
 public:
 	// CONSTRUCTORS/DESTRUCTOR
 	// Create a new SequentialList with the given number of elements.
-	SequentialList(unsigned int cap);
+	explicit SequentialList(unsigned int cap, const CapacityPolicy& policy = CapacityPolicy());
+
+	// Copies every element of rhs.
+	SequentialList(const SequentialList& rhs);
+
+	// Takes over the block of rhs, leaving rhs empty with no block.
+	SequentialList(SequentialList&& rhs) noexcept;
 
 	//Destroy this SequentialList, freeing all dynamically allocated memory.
 	~SequentialList();
 
+	SequentialList& operator=(const SequentialList& rhs);
+	SequentialList& operator=(SequentialList&& rhs) noexcept;
+
 
 	// ACCESSORS
 	// Returns the number of elements in the list.
@@ -55,13 +121,50 @@ public:
 	// Returns true if the list is at capacity, false otherwise.
 	bool full() const;
 
+	// Returns how many times the list has reallocated, and how many bytes
+	// that moved.
+	const CapacityStats& capacity_stats() const { return policy_.stats(); }
+
+	// Grows the capacity to at least cap, so the next inserts up to that
+	// size do not reallocate. Removing below a quarter of the capacity still
+	// shrinks it.
+	void reserve(unsigned int cap);
+
+	// Shrinks the capacity to the size (but not below the minimum capacity).
+	void shrink_to_fit();
+
 	// Returns the value at the given index in the list. If index is invalid,
-	// return the value of the last element.
+	// returns -999 for int and a default constructed value for other types.
 	DataType select(unsigned int index) const;
 
+	// Unchecked access to the element at index, without copying it.
+	DataType& operator[](unsigned int index) { return data_[index]; }
+	const DataType& operator[](unsigned int index) const { return data_[index]; }
+
 	// Searches for the given value, and returns the index of this value if found.
 	// Returns the size of the list otherwise
-	unsigned int search(DataType val) const;
+	unsigned int search(const DataType& val) const;
+
+	// Returns how many elements equal the given value.
+	unsigned int count(const DataType& val) const;
+
+	// Returns the smallest / largest element. If the list is empty, returns
+	// what select() returns for an invalid index.
+	DataType min() const;
+	DataType max() const;
+
+	// Returns the index of the first element in [lo, hi], or the size of the
+	// list if there is none.
+	unsigned int find_between(const DataType& lo, const DataType& hi) const;
+
+	// Returns how many elements are in [lo, hi].
+	unsigned int count_between(const DataType& lo, const DataType& hi) const;
+
+	// Returns the index of the first element for which pred returns true, or
+	// the size of the list if there is none. Always a plain loop: prefer
+	// search or find_between where they say the same thing.
+	template <class Pred>
+	unsigned int find_if(Pred pred) const;
 
 	// Prints all elements in the list to the standard output.
 	void print() const;
@@ -69,17 +172,47 @@ public:
 
 	// MUTATORS
 	// Inserts a value into the list at a given index.
-	bool insert(DataType val, unsigned int index);
+	bool insert(const DataType& val, unsigned int index);
+	bool insert(DataType&& val, unsigned int index);
 
 	// Inserts a value at the beginning of the list.
-	bool insert_front(DataType val);
+	bool insert_front(const DataType& val);
+	bool insert_front(DataType&& val);
 
 	// Inserts a value at the end of the list.
-	bool insert_back(DataType val);
+	bool insert_back(const DataType& val);
+	bool insert_back(DataType&& val);
+
+	// Constructs a value from args at the given index.
+	template <class... Args>
+	bool emplace(unsigned int index, Args&&... args);
+
+	// Constructs a value from args at the beginning of the list.
+	template <class... Args>
+	bool emplace_front(Args&&... args);
+
+	// Constructs a value from args at the end of the list.
+	template <class... Args>
+	bool emplace_back(Args&&... args);
+
+	// Inserts copies of [first, last) at the given index, shifting the
+	// elements after it once for the whole range. The range must not point
+	// into this list.
+	template <class ForwardIt>
+	bool insert_range(unsigned int index, ForwardIt first, ForwardIt last);
+
+	// Appends copies of [first, last). A forward range reallocates at most
+	// once; a single-pass range grows as it goes.
+	template <class InputIt>
+	bool append_range(InputIt first, InputIt last);
 
 	// Deletes a value from the list at the given index.
 	bool remove(unsigned int index);
 
+	// Deletes the values at indexes [first, last), shifting the elements
+	// after them once.
+	bool remove_range(unsigned int first, unsigned int last);
+
 	// Deletes a value from the beginning of the list.
 	bool remove_front();
 
@@ -87,8 +220,560 @@ public:
 	bool remove_back();
 
 	// Replaces the value at the given index with the given value.
-	bool replace(unsigned int index, DataType val);	
+	bool replace(unsigned int index, const DataType& val);
+	bool replace(unsigned int index, DataType&& val);
+
+};
+
+
+template <class T>
+const unsigned int SequentialList<T>::MIN_CAPACITY;
+
+template <class T>
+const bool SequentialList<T>::TRIVIAL;
+
+
+// Value select() returns for an invalid index.
+template <class T>
+inline T invalidSelection() { return T(); }
+
+template <>
+inline int invalidSelection<int>() { return -999; }
+
+
+// The whole-list scans, over n elements at data. min and max need n > 0.
+template <class T>
+struct ListScan {
+    static unsigned int find(const T* data, unsigned int n, const T& val) {
+        for (unsigned int i = 0; i < n; ++i) {
+            if (data[i] == val) return i;
+        }
+        return n;
+    }
+
+    static unsigned int count(const T* data, unsigned int n, const T& val) {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < n; ++i) {
+            if (data[i] == val) count++;
+        }
+        return count;
+    }
+
+    static const T& min(const T* data, unsigned int n) {
+        const T* best = data;
+        for (unsigned int i = 1; i < n; ++i) {
+            if (data[i] < *best) best = data + i;
+        }
+        return *best;
+    }
+
+    static const T& max(const T* data, unsigned int n) {
+        const T* best = data;
+        for (unsigned int i = 1; i < n; ++i) {
+            if (*best < data[i]) best = data + i;
+        }
+        return *best;
+    }
+
+    static unsigned int find_between(const T* data, unsigned int n, const T& lo, const T& hi) {
+        for (unsigned int i = 0; i < n; ++i) {
+            if (!(data[i] < lo) && !(hi < data[i])) return i;
+        }
+        return n;
+    }
+
+    static unsigned int count_between(const T* data, unsigned int n, const T& lo, const T& hi) {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < n; ++i) {
+            if (!(data[i] < lo) && !(hi < data[i])) count++;
+        }
+        return count;
+    }
+};
 
+template <>
+struct ListScan<int> {
+    static unsigned int find(const int* data, unsigned int n, int val) {
+        return simd_scan::kernels().find(data, n, val);
+    }
+
+    static unsigned int count(const int* data, unsigned int n, int val) {
+        return simd_scan::kernels().count(data, n, val);
+    }
+
+    static int min(const int* data, unsigned int n) { return simd_scan::kernels().min(data, n); }
+    static int max(const int* data, unsigned int n) { return simd_scan::kernels().max(data, n); }
+
+    static unsigned int find_between(const int* data, unsigned int n, int lo, int hi) {
+        return simd_scan::kernels().find_between(data, n, lo, hi);
+    }
+
+    static unsigned int count_between(const int* data, unsigned int n, int lo, int hi) {
+        return simd_scan::kernels().count_between(data, n, lo, hi);
+    }
 };
 
+
+template <class T>
+T* SequentialList<T>::allocate(unsigned int cap) {
+    void* block = std::malloc(sizeof(T) * cap);
+    if (block == nullptr) throw std::bad_alloc();
+    return static_cast<T*>(block);
+}
+
+template <class T>
+void SequentialList<T>::relocate(unsigned int cap) {
+    if (TRIVIAL) {
+        void* block = std::realloc(static_cast<void*>(data_), sizeof(T) * cap);
+        if (block == nullptr) throw std::bad_alloc();
+        data_ = static_cast<T*>(block);
+    } else {
+        T* newData = allocate(cap);
+        for (unsigned int i = 0; i < size_; ++i) {
+            new (newData + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        std::free(data_);
+        data_ = newData;
+    }
+    policy_.record_resize(cap > capacity_, sizeof(T) * size_);
+    capacity_ = cap;
+}
+
+template <class T>
+void SequentialList<T>::growFor(unsigned int needed) {
+    if (needed <= capacity_) return;
+    // a moved-from list starts over at the minimum
+    unsigned int cap = capacity_ < minCapacity() ? minCapacity() : capacity_;
+    relocate(policy_.grow_to(cap, needed));
+}
+
+template <class T>
+void SequentialList<T>::openGap(unsigned int index, unsigned int count) {
+    if (count == 0) return;
+    if (TRIVIAL) {
+        std::memmove(static_cast<void*>(data_ + index + count), data_ + index, sizeof(T) * (size_ - index));
+    } else {
+        // move from the back, so nothing is overwritten before it has moved
+        for (unsigned int i = size_; i > index; --i) {
+            new (data_ + i - 1 + count) T(std::move(data_[i - 1]));
+            data_[i - 1].~T();
+        }
+    }
+}
+
+template <class T>
+void SequentialList<T>::closeGap(unsigned int index, unsigned int count) {
+    if (count == 0) return;
+    if (TRIVIAL) {
+        std::memmove(static_cast<void*>(data_ + index), data_ + index + count, sizeof(T) * (size_ - index));
+    } else {
+        // move from the front, so nothing is overwritten before it has moved
+        for (unsigned int i = index; i < size_; ++i) {
+            new (data_ + i) T(std::move(data_[i + count]));
+            data_[i + count].~T();
+        }
+    }
+}
+
+template <class T>
+void SequentialList<T>::destroyAll() {
+    if (!TRIVIAL) {
+        for (unsigned int i = 0; i < size_; ++i) data_[i].~T();
+    }
+    size_ = 0;
+}
+
+
+template <class T>
+SequentialList<T>::SequentialList(unsigned int cap, const CapacityPolicy& policy)
+    : policy_(policy), capacity_(cap >= minCapacity() ? cap : minCapacity()), size_(0), data_(allocate(capacity_)) {}
+
+template <class T>
+SequentialList<T>::SequentialList(const SequentialList& rhs)
+    : policy_(rhs.policy_), capacity_(rhs.capacity_), size_(0), data_(allocate(capacity_)) {
+    if (TRIVIAL) {
+        std::memcpy(static_cast<void*>(data_), rhs.data_, sizeof(T) * rhs.size_);
+        size_ = rhs.size_;
+    } else {
+        try {
+            for (; size_ < rhs.size_; ++size_) new (data_ + size_) T(rhs.data_[size_]);
+        } catch (...) {
+            destroyAll();
+            std::free(data_);
+            throw;
+        }
+    }
+}
+
+template <class T>
+SequentialList<T>::SequentialList(SequentialList&& rhs) noexcept
+    : policy_(rhs.policy_), capacity_(rhs.capacity_), size_(rhs.size_), data_(rhs.data_) {
+    rhs.capacity_ = 0;
+    rhs.size_ = 0;
+    rhs.data_ = nullptr;
+}
+
+template <class T>
+SequentialList<T>::~SequentialList() {
+    destroyAll();
+    std::free(data_);
+    data_ = nullptr;
+}
+
+template <class T>
+SequentialList<T>& SequentialList<T>::operator=(const SequentialList& rhs) {
+    if (this != &rhs) {
+        SequentialList copy(rhs);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+template <class T>
+SequentialList<T>& SequentialList<T>::operator=(SequentialList&& rhs) noexcept {
+    if (this != &rhs) {
+        std::swap(policy_, rhs.policy_);
+        std::swap(capacity_, rhs.capacity_);
+        std::swap(size_, rhs.size_);
+        std::swap(data_, rhs.data_);
+    }
+    return *this;
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::size() const {
+    return size_;
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::capacity() const {
+    return capacity_;
+}
+
+
+template <class T>
+bool SequentialList<T>::empty() const {
+    return size_ == 0;
+}
+
+
+template <class T>
+bool SequentialList<T>::full() const {
+    return size_ == capacity_;
+}
+
+
+template <class T>
+T SequentialList<T>::select(unsigned int index) const {
+    if (index >= size_) return invalidSelection<T>();
+
+    return data_[index];
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::search(const T& val) const {
+    // index of val, or size_ if not found
+    return ListScan<T>::find(data_, size_, val);
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::count(const T& val) const {
+    return ListScan<T>::count(data_, size_, val);
+}
+
+
+template <class T>
+T SequentialList<T>::min() const {
+    if (size_ == 0) return invalidSelection<T>();
+
+    return ListScan<T>::min(data_, size_);
+}
+
+
+template <class T>
+T SequentialList<T>::max() const {
+    if (size_ == 0) return invalidSelection<T>();
+
+    return ListScan<T>::max(data_, size_);
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::find_between(const T& lo, const T& hi) const {
+    return ListScan<T>::find_between(data_, size_, lo, hi);
+}
+
+
+template <class T>
+unsigned int SequentialList<T>::count_between(const T& lo, const T& hi) const {
+    return ListScan<T>::count_between(data_, size_, lo, hi);
+}
+
+
+template <class T>
+template <class Pred>
+unsigned int SequentialList<T>::find_if(Pred pred) const {
+    for (unsigned int i = 0; i < size_; ++i) {
+        if (pred(data_[i])) return i;
+    }
+    return size_;
+}
+
+
+template <class T>
+void SequentialList<T>::print() const {
+
+    // iterate through array
+    for (unsigned int i = 0; i < size_; ++i) {
+        std::cout << data_[i] << " ";
+    }
+    // end of array
+    std::cout << "\n";
+}
+
+
+template <class T>
+template <class... Args>
+bool SequentialList<T>::emplace(unsigned int index, Args&&... args) {
+    if (index > size_) return false; // index cannot be larger than size
+
+    // Appending with room to spare: nothing moves, so construct in place
+    if (index == size_ && !full()) {
+        new (data_ + size_) T(std::forward<Args>(args)...);
+        ++size_;
+        return true;
+    }
+
+    // args may refer to an element of this list, which is about to move
+    T val(std::forward<Args>(args)...);
+
+    // Resize if full
+    growFor(size_ + 1);
+
+    // Shift elements to the right
+    if (TRIVIAL) {
+        std::memmove(static_cast<void*>(data_ + index + 1), data_ + index, sizeof(T) * (size_ - index));
+        std::memcpy(static_cast<void*>(data_ + index), &val, sizeof(T));
+    } else if (index == size_) {
+        new (data_ + size_) T(std::move(val));
+    } else {
+        new (data_ + size_) T(std::move(data_[size_ - 1]));
+        for (unsigned int i = size_ - 1; i > index; --i) {
+            data_[i] = std::move(data_[i - 1]);
+        }
+        data_[index] = std::move(val);
+    }
+
+    ++size_;
+    return true;
+}
+
+
+template <class T>
+template <class... Args>
+bool SequentialList<T>::emplace_front(Args&&... args) {
+    return emplace(0, std::forward<Args>(args)...);
+}
+
+
+template <class T>
+template <class... Args>
+bool SequentialList<T>::emplace_back(Args&&... args) {
+    return emplace(size_, std::forward<Args>(args)...);
+}
+
+
+template <class T>
+bool SequentialList<T>::insert(const T& val, unsigned int index) {
+    return emplace(index, val);
+}
+
+
+template <class T>
+bool SequentialList<T>::insert(T&& val, unsigned int index) {
+    return emplace(index, std::move(val));
+}
+
+
+template <class T>
+bool SequentialList<T>::insert_front(const T& val) {
+    return emplace(0, val);
+}
+
+
+template <class T>
+bool SequentialList<T>::insert_front(T&& val) {
+    return emplace(0, std::move(val));
+}
+
+
+template <class T>
+bool SequentialList<T>::insert_back(const T& val) {
+    return emplace(size_, val);
+}
+
+
+template <class T>
+bool SequentialList<T>::insert_back(T&& val) {
+    return emplace(size_, std::move(val));
+}
+
+
+template <class T>
+template <class ForwardIt>
+bool SequentialList<T>::insert_range(unsigned int index, ForwardIt first, ForwardIt last) {
+    if (index > size_) return false; // index cannot be larger than size
+
+    typename std::iterator_traits<ForwardIt>::difference_type count = std::distance(first, last);
+    if (count < 0 || (unsigned long long)count > UINT_MAX - size_)
+        throw std::length_error("SequentialList::insert_range: too many elements");
+
+    // One reallocation and one shift for the whole range
+    growFor(size_ + (unsigned int)count);
+    openGap(index, (unsigned int)count);
+
+    // Fill the gap. If a copy throws, destroy the copies made so far and
+    // close the gap again, so the list is left as it was.
+    unsigned int i = index;
+    try {
+        for (; first != last; ++first, ++i) {
+            new (data_ + i) T(*first);
+        }
+    } catch (...) {
+        for (unsigned int j = index; j < i; ++j) data_[j].~T();
+        closeGap(index, (unsigned int)count);
+        throw;
+    }
+    size_ += (unsigned int)count;
+    return true;
+}
+
+
+template <class T>
+template <class InputIt>
+bool SequentialList<T>::append_range(InputIt first, InputIt last) {
+    return append_range(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+
+template <class T>
+template <class InputIt>
+bool SequentialList<T>::append_range(InputIt first, InputIt last, std::input_iterator_tag) {
+    for (; first != last; ++first) emplace_back(*first);
+    return true;
+}
+
+
+template <class T>
+template <class ForwardIt>
+bool SequentialList<T>::append_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    return insert_range(size_, first, last);
+}
+
+
+template <class T>
+void SequentialList<T>::reserve(unsigned int cap) {
+    if (cap > capacity_) relocate(cap);
+}
+
+
+template <class T>
+void SequentialList<T>::shrink_to_fit() {
+    unsigned int cap = size_ < minCapacity() ? minCapacity() : size_;
+    if (cap < capacity_) relocate(cap);
+}
+
+
+template <class T>
+bool SequentialList<T>::remove(unsigned int index) {
+    if (empty() || index >= size_) return false;
+
+    // Shift elements to the left
+    if (TRIVIAL) {
+        std::memmove(static_cast<void*>(data_ + index), data_ + index + 1, sizeof(T) * (size_ - index - 1));
+    } else {
+        for (unsigned int i = index; i < size_ - 1; ++i) {
+            data_[i] = std::move(data_[i + 1]);
+        }
+        data_[size_ - 1].~T();
+    }
+
+    --size_;
+
+    // Shrink the array if necessary
+    if (policy_.should_shrink(size_, capacity_, minCapacity())) {
+        relocate(policy_.shrink_to(capacity_, minCapacity()));
+    }
+
+    return true;
+}
+
+
+template <class T>
+bool SequentialList<T>::remove_range(unsigned int first, unsigned int last) {
+    if (first > last || last > size_) return false;
+    if (first == last) return true;
+    unsigned int count = last - first;
+
+    // Shift the tail left over the whole range at once
+    if (TRIVIAL) {
+        std::memmove(static_cast<void*>(data_ + first), data_ + last, sizeof(T) * (size_ - last));
+    } else {
+        for (unsigned int i = last; i < size_; ++i) {
+            data_[i - count] = std::move(data_[i]);
+        }
+        for (unsigned int i = size_ - count; i < size_; ++i) data_[i].~T();
+    }
+
+    size_ -= count;
+
+    // Shrink the array if necessary, as many steps as remove would have
+    // taken over the same elements, in one reallocation
+    if (policy_.should_shrink(size_, capacity_, minCapacity(), count)) {
+        unsigned int newCapacity = capacity_;
+        do {
+            newCapacity = policy_.shrink_to(newCapacity, minCapacity());
+        } while (policy_.sparse(size_, newCapacity, minCapacity()));
+        relocate(newCapacity);
+    }
+
+    return true;
+}
+
+
+template <class T>
+bool SequentialList<T>::remove_front() {
+    return remove(0);
+}
+
+
+template <class T>
+bool SequentialList<T>::remove_back() {
+    return remove(size_ - 1);
+}
+
+
+template <class T>
+bool SequentialList<T>::replace(unsigned int index, const T& val) {
+    if (index >= size_) return false;
+
+    // in bounds insert
+    data_[index] = val;
+    return true;
+}
+
+
+template <class T>
+bool SequentialList<T>::replace(unsigned int index, T&& val) {
+    if (index >= size_) return false;
+
+    data_[index] = std::move(val);
+    return true;
+}
+
 #endif
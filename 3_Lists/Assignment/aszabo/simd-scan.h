@@ -0,0 +1,312 @@
+#ifndef LAB1_SIMD_SCAN_H
+#define LAB1_SIMD_SCAN_H
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// Linear scans over an array of ints, vectorized with SSE4.1 or AVX2.
+//
+// Each scan comes in three versions: plain loops, 4 ints at a time with
+// SSE4.1 and 8 at a time with AVX2. The vector versions are compiled with a
+// per-function target attribute, so the rest of the program needs no special
+// flags, and kernels() picks the best one the CPU running the program
+// supports, once. Every version returns exactly what the plain loop would.
+//
+// The compare loops test 32 ints per iteration (four AVX2 registers) with a
+// single branch, and only look for which lane matched once one has. count,
+// min and max keep several accumulators so consecutive loads do not wait on
+// each other.
+namespace simd_scan {
+
+enum Level { SCALAR, SSE4, AVX2 };
+
+// The kernels for one level. find* return the index of the first match, or
+// n if there is none; min and max need n > 0.
+struct Kernels {
+    Level level;
+    unsigned int (*find)(const int* data, unsigned int n, int value);
+    unsigned int (*count)(const int* data, unsigned int n, int value);
+    int (*min)(const int* data, unsigned int n);
+    int (*max)(const int* data, unsigned int n);
+    unsigned int (*find_between)(const int* data, unsigned int n, int lo, int hi);
+    unsigned int (*count_between)(const int* data, unsigned int n, int lo, int hi);
+};
+
+
+// SCALAR
+
+inline unsigned int find_scalar(const int* data, unsigned int n, int value) {
+    for (unsigned int i = 0; i < n; ++i) {
+        if (data[i] == value) return i;
+    }
+    return n;
+}
+
+inline unsigned int count_scalar(const int* data, unsigned int n, int value) {
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < n; ++i) count += data[i] == value;
+    return count;
+}
+
+inline int min_scalar(const int* data, unsigned int n) {
+    int best = data[0];
+    for (unsigned int i = 1; i < n; ++i) best = data[i] < best ? data[i] : best;
+    return best;
+}
+
+inline int max_scalar(const int* data, unsigned int n) {
+    int best = data[0];
+    for (unsigned int i = 1; i < n; ++i) best = data[i] > best ? data[i] : best;
+    return best;
+}
+
+inline unsigned int find_between_scalar(const int* data, unsigned int n, int lo, int hi) {
+    for (unsigned int i = 0; i < n; ++i) {
+        if (lo <= data[i] && data[i] <= hi) return i;
+    }
+    return n;
+}
+
+inline unsigned int count_between_scalar(const int* data, unsigned int n, int lo, int hi) {
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < n; ++i) count += lo <= data[i] && data[i] <= hi;
+    return count;
+}
+
+
+#ifdef SIMD_SCAN_X86
+
+// SSE4.1
+
+// lanes of x equal to value, as all-ones
+#define SIMD_SCAN_EQ_128(x) _mm_cmpeq_epi32((x), target)
+// lanes of x in [lo, hi], as all-ones: clamping them leaves them unchanged
+#define SIMD_SCAN_IN_128(x) _mm_cmpeq_epi32(_mm_max_epi32(_mm_min_epi32((x), high), low), (x))
+
+#define SIMD_SCAN_FIND_128(MATCH, SCALAR_TAIL)                                                      \
+    unsigned int i = 0;                                                                             \
+    for (; i + 16 <= n; i += 16) {                                                                  \
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i));                                    \
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 4));                                \
+        __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 8));                                \
+        __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 12));                               \
+        __m128i any = _mm_or_si128(_mm_or_si128(MATCH(a), MATCH(b)), _mm_or_si128(MATCH(c), MATCH(d))); \
+        if (!_mm_testz_si128(any, any)) break;                                                      \
+    }                                                                                               \
+    for (; i + 4 <= n; i += 4) {                                                                    \
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(MATCH(_mm_loadu_si128((const __m128i*)(data + i))))); \
+        if (mask != 0) return i + __builtin_ctz(mask);                                              \
+    }                                                                                               \
+    return i + SCALAR_TAIL;
+
+#define SIMD_SCAN_COUNT_128(MATCH, SCALAR_TAIL)                                                     \
+    __m128i sum0 = _mm_setzero_si128(), sum1 = _mm_setzero_si128();                                 \
+    unsigned int i = 0;                                                                             \
+    for (; i + 8 <= n; i += 8) {                                                                    \
+        sum0 = _mm_sub_epi32(sum0, MATCH(_mm_loadu_si128((const __m128i*)(data + i))));             \
+        sum1 = _mm_sub_epi32(sum1, MATCH(_mm_loadu_si128((const __m128i*)(data + i + 4))));         \
+    }                                                                                               \
+    __m128i sum = _mm_add_epi32(sum0, sum1);                                                        \
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));                                         \
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));                                         \
+    return (unsigned int)_mm_cvtsi128_si32(sum) + SCALAR_TAIL;
+
+#define SIMD_SCAN_REDUCE_128(OP, SCALAR)                                                            \
+    if (n < 16) return SCALAR(data, n);                                                             \
+    __m128i r0 = _mm_loadu_si128((const __m128i*)data), r1 = r0, r2 = r0, r3 = r0;                  \
+    unsigned int i = 0;                                                                             \
+    for (; i + 16 <= n; i += 16) {                                                                  \
+        r0 = OP(r0, _mm_loadu_si128((const __m128i*)(data + i)));                                   \
+        r1 = OP(r1, _mm_loadu_si128((const __m128i*)(data + i + 4)));                               \
+        r2 = OP(r2, _mm_loadu_si128((const __m128i*)(data + i + 8)));                               \
+        r3 = OP(r3, _mm_loadu_si128((const __m128i*)(data + i + 12)));                              \
+    }                                                                                               \
+    /* the last 16 may overlap what was already seen, which min and max do not mind */              \
+    r0 = OP(r0, _mm_loadu_si128((const __m128i*)(data + n - 16)));                                  \
+    r1 = OP(r1, _mm_loadu_si128((const __m128i*)(data + n - 12)));                                  \
+    r2 = OP(r2, _mm_loadu_si128((const __m128i*)(data + n - 8)));                                   \
+    r3 = OP(r3, _mm_loadu_si128((const __m128i*)(data + n - 4)));                                   \
+    __m128i r = OP(OP(r0, r1), OP(r2, r3));                                                         \
+    r = OP(r, _mm_shuffle_epi32(r, 0x4E));                                                          \
+    r = OP(r, _mm_shuffle_epi32(r, 0xB1));                                                          \
+    return _mm_cvtsi128_si32(r);
+
+__attribute__((target("sse4.1")))
+inline unsigned int find_sse4(const int* data, unsigned int n, int value) {
+    __m128i target = _mm_set1_epi32(value);
+    SIMD_SCAN_FIND_128(SIMD_SCAN_EQ_128, find_scalar(data + i, n - i, value))
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned int count_sse4(const int* data, unsigned int n, int value) {
+    __m128i target = _mm_set1_epi32(value);
+    SIMD_SCAN_COUNT_128(SIMD_SCAN_EQ_128, count_scalar(data + i, n - i, value))
+}
+
+__attribute__((target("sse4.1")))
+inline int min_sse4(const int* data, unsigned int n) {
+    SIMD_SCAN_REDUCE_128(_mm_min_epi32, min_scalar)
+}
+
+__attribute__((target("sse4.1")))
+inline int max_sse4(const int* data, unsigned int n) {
+    SIMD_SCAN_REDUCE_128(_mm_max_epi32, max_scalar)
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned int find_between_sse4(const int* data, unsigned int n, int lo, int hi) {
+    if (lo > hi) return n;
+    __m128i low = _mm_set1_epi32(lo), high = _mm_set1_epi32(hi);
+    SIMD_SCAN_FIND_128(SIMD_SCAN_IN_128, find_between_scalar(data + i, n - i, lo, hi))
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned int count_between_sse4(const int* data, unsigned int n, int lo, int hi) {
+    if (lo > hi) return 0;
+    __m128i low = _mm_set1_epi32(lo), high = _mm_set1_epi32(hi);
+    SIMD_SCAN_COUNT_128(SIMD_SCAN_IN_128, count_between_scalar(data + i, n - i, lo, hi))
+}
+
+
+// AVX2
+
+#define SIMD_SCAN_EQ_256(x) _mm256_cmpeq_epi32((x), target)
+#define SIMD_SCAN_IN_256(x) _mm256_cmpeq_epi32(_mm256_max_epi32(_mm256_min_epi32((x), high), low), (x))
+
+#define SIMD_SCAN_FIND_256(MATCH, SCALAR_TAIL)                                                      \
+    unsigned int i = 0;                                                                             \
+    for (; i + 32 <= n; i += 32) {                                                                  \
+        __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));                                 \
+        __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 8));                             \
+        __m256i c = _mm256_loadu_si256((const __m256i*)(data + i + 16));                            \
+        __m256i d = _mm256_loadu_si256((const __m256i*)(data + i + 24));                            \
+        __m256i any = _mm256_or_si256(_mm256_or_si256(MATCH(a), MATCH(b)), _mm256_or_si256(MATCH(c), MATCH(d))); \
+        if (!_mm256_testz_si256(any, any)) break;                                                   \
+    }                                                                                               \
+    for (; i + 8 <= n; i += 8) {                                                                    \
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(MATCH(_mm256_loadu_si256((const __m256i*)(data + i))))); \
+        if (mask != 0) return i + __builtin_ctz(mask);                                              \
+    }                                                                                               \
+    return i + SCALAR_TAIL;
+
+#define SIMD_SCAN_COUNT_256(MATCH, SCALAR_TAIL)                                                     \
+    __m256i sum0 = _mm256_setzero_si256(), sum1 = _mm256_setzero_si256();                           \
+    unsigned int i = 0;                                                                             \
+    for (; i + 16 <= n; i += 16) {                                                                  \
+        sum0 = _mm256_sub_epi32(sum0, MATCH(_mm256_loadu_si256((const __m256i*)(data + i))));       \
+        sum1 = _mm256_sub_epi32(sum1, MATCH(_mm256_loadu_si256((const __m256i*)(data + i + 8))));   \
+    }                                                                                               \
+    __m256i sum8 = _mm256_add_epi32(sum0, sum1);                                                    \
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum8), _mm256_extracti128_si256(sum8, 1));   \
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));                                         \
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));                                         \
+    return (unsigned int)_mm_cvtsi128_si32(sum) + SCALAR_TAIL;
+
+#define SIMD_SCAN_REDUCE_256(OP, OP128, SCALAR)                                                     \
+    if (n < 32) return SCALAR(data, n);                                                             \
+    __m256i r0 = _mm256_loadu_si256((const __m256i*)data), r1 = r0, r2 = r0, r3 = r0;               \
+    unsigned int i = 0;                                                                             \
+    for (; i + 32 <= n; i += 32) {                                                                  \
+        r0 = OP(r0, _mm256_loadu_si256((const __m256i*)(data + i)));                                \
+        r1 = OP(r1, _mm256_loadu_si256((const __m256i*)(data + i + 8)));                            \
+        r2 = OP(r2, _mm256_loadu_si256((const __m256i*)(data + i + 16)));                           \
+        r3 = OP(r3, _mm256_loadu_si256((const __m256i*)(data + i + 24)));                           \
+    }                                                                                               \
+    r0 = OP(r0, _mm256_loadu_si256((const __m256i*)(data + n - 32)));                               \
+    r1 = OP(r1, _mm256_loadu_si256((const __m256i*)(data + n - 24)));                               \
+    r2 = OP(r2, _mm256_loadu_si256((const __m256i*)(data + n - 16)));                               \
+    r3 = OP(r3, _mm256_loadu_si256((const __m256i*)(data + n - 8)));                                \
+    __m256i r8 = OP(OP(r0, r1), OP(r2, r3));                                                        \
+    __m128i r = OP128(_mm256_castsi256_si128(r8), _mm256_extracti128_si256(r8, 1));                 \
+    r = OP128(r, _mm_shuffle_epi32(r, 0x4E));                                                       \
+    r = OP128(r, _mm_shuffle_epi32(r, 0xB1));                                                       \
+    return _mm_cvtsi128_si32(r);
+
+__attribute__((target("avx2")))
+inline unsigned int find_avx2(const int* data, unsigned int n, int value) {
+    __m256i target = _mm256_set1_epi32(value);
+    SIMD_SCAN_FIND_256(SIMD_SCAN_EQ_256, find_scalar(data + i, n - i, value))
+}
+
+__attribute__((target("avx2")))
+inline unsigned int count_avx2(const int* data, unsigned int n, int value) {
+    __m256i target = _mm256_set1_epi32(value);
+    SIMD_SCAN_COUNT_256(SIMD_SCAN_EQ_256, count_scalar(data + i, n - i, value))
+}
+
+__attribute__((target("avx2")))
+inline int min_avx2(const int* data, unsigned int n) {
+    SIMD_SCAN_REDUCE_256(_mm256_min_epi32, _mm_min_epi32, min_scalar)
+}
+
+__attribute__((target("avx2")))
+inline int max_avx2(const int* data, unsigned int n) {
+    SIMD_SCAN_REDUCE_256(_mm256_max_epi32, _mm_max_epi32, max_scalar)
+}
+
+__attribute__((target("avx2")))
+inline unsigned int find_between_avx2(const int* data, unsigned int n, int lo, int hi) {
+    if (lo > hi) return n;
+    __m256i low = _mm256_set1_epi32(lo), high = _mm256_set1_epi32(hi);
+    SIMD_SCAN_FIND_256(SIMD_SCAN_IN_256, find_between_scalar(data + i, n - i, lo, hi))
+}
+
+__attribute__((target("avx2")))
+inline unsigned int count_between_avx2(const int* data, unsigned int n, int lo, int hi) {
+    if (lo > hi) return 0;
+    __m256i low = _mm256_set1_epi32(lo), high = _mm256_set1_epi32(hi);
+    SIMD_SCAN_COUNT_256(SIMD_SCAN_IN_256, count_between_scalar(data + i, n - i, lo, hi))
+}
+
+#undef SIMD_SCAN_EQ_128
+#undef SIMD_SCAN_IN_128
+#undef SIMD_SCAN_FIND_128
+#undef SIMD_SCAN_COUNT_128
+#undef SIMD_SCAN_REDUCE_128
+#undef SIMD_SCAN_EQ_256
+#undef SIMD_SCAN_IN_256
+#undef SIMD_SCAN_FIND_256
+#undef SIMD_SCAN_COUNT_256
+#undef SIMD_SCAN_REDUCE_256
+
+#endif  // SIMD_SCAN_X86
+
+
+// The kernels of the given level. A level the CPU does not support must
+// not be run; see supported().
+inline Kernels kernels_for(Level level) {
+#ifdef SIMD_SCAN_X86
+    if (level == AVX2) {
+        Kernels k = {AVX2, find_avx2, count_avx2, min_avx2, max_avx2, find_between_avx2, count_between_avx2};
+        return k;
+    }
+    if (level == SSE4) {
+        Kernels k = {SSE4, find_sse4, count_sse4, min_sse4, max_sse4, find_between_sse4, count_between_sse4};
+        return k;
+    }
+#endif
+    Kernels k = {SCALAR, find_scalar, count_scalar, min_scalar, max_scalar, find_between_scalar,
+                 count_between_scalar};
+    return k;
+}
+
+// True if this CPU can run the kernels of the given level.
+inline bool supported(Level level) {
+#ifdef SIMD_SCAN_X86
+    if (level == AVX2) return __builtin_cpu_supports("avx2");
+    if (level == SSE4) return __builtin_cpu_supports("sse4.1");
+#endif
+    return level == SCALAR;
+}
+
+// The fastest kernels this CPU supports, chosen on the first call.
+inline const Kernels& kernels() {
+    static const Kernels best = kernels_for(supported(AVX2) ? AVX2 : supported(SSE4) ? SSE4 : SCALAR);
+    return best;
+}
+
+}  // namespace simd_scan
+
+#endif  // LAB1_SIMD_SCAN_H
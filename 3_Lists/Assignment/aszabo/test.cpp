@@ -11,10 +11,12 @@
 
 #include <iostream>
 #include <string>
+#include <stdexcept>
 
 // Comment/Uncomment the .h files when you're ready to start testing
 #include "sequential-list.h"
 #include "doubly-linked-list.h"
+#include "unrolled-linked-list.h"
 
 // Once uncommented, you will need to modify the CMakeLists.txt
 // to add the .cpp file to be able to compile again.
@@ -36,6 +38,28 @@ string get_status_str(bool status) {
 }
 
 
+// An element whose copies start failing once copies_left runs out, and that
+// counts how many of it are alive.
+struct Fragile {
+    static int copies_left;
+    static int live;
+    string name;
+
+    Fragile(const char* n) : name(n) { ++live; }
+    Fragile(const Fragile& rhs) : name(rhs.name) {
+        if (copies_left-- <= 0) throw runtime_error("copy failed");
+        ++live;
+    }
+    Fragile(Fragile&& rhs) noexcept : name(std::move(rhs.name)) { ++live; }
+    Fragile& operator=(const Fragile& rhs) = default;
+    Fragile& operator=(Fragile&& rhs) = default;
+    ~Fragile() { --live; }
+};
+
+int Fragile::copies_left = 0;
+int Fragile::live = 0;
+
+
 class SequentialListTest {
 public:
     bool test1();
@@ -48,6 +72,10 @@ public:
     bool test8();
     bool test9();
     bool test10();
+    bool test11();
+    bool test12();
+    bool test13();
+    bool test14();
 };
 
 
@@ -64,9 +92,22 @@ public:
     bool test9();
     bool test10();
     bool test11();
+    bool test12();
     bool regularFunctionalityTest();
 };
 
+
+class UnrolledLinkedListTest{
+public:
+    bool test1();
+    bool test2();
+    bool test3();
+
+private:
+    // Links, counts and fill of every node agree with the list's size.
+    bool checkNodes(const UnrolledLinkedList& list);
+};
+
 int main() {
 
     int grade = 0;
@@ -112,6 +153,16 @@ int main() {
     cout << endl
          << "Total grade: " << grade << endl << endl;
 
+    // additional tests
+    cout << "Test11: strings are moved, copied and emplaced correctly" << endl
+         << get_status_str(seq_test.test11()) << endl;
+    cout << "Test12: range inserts and removes, reserve() and shrink_to_fit()" << endl
+         << get_status_str(seq_test.test12()) << endl;
+    cout << "Test13: capacity policy and reallocation counters" << endl
+         << get_status_str(seq_test.test13()) << endl;
+    cout << "Test14: search, count, min, max and range scans" << endl
+         << get_status_str(seq_test.test14()) << endl << endl;
+
 
     //
     // Can put additional tests bellow.
@@ -166,6 +217,19 @@ int main() {
              << get_status_str(linked_test_results[10]) << endl;
     cout << linked_test_descriptions[11] << endl
              << get_status_str(linked_test_results[11]) << endl;
+    cout << "Test 13: Nodes come from the pool and are reused" << endl
+             << get_status_str(linked_test.test12()) << endl << endl;
+
+    UnrolledLinkedListTest unrolled_test;
+
+    cout << "UNROLLED LINKED LIST TESTING RESULTS \n";
+    cout << "************************************ \n";
+    cout << "Test1: Regular functionality test mimicking a user's actions" << endl
+         << get_status_str(unrolled_test.test1()) << endl;
+    cout << "Test2: nodes split when full and merge when under half full" << endl
+         << get_status_str(unrolled_test.test2()) << endl;
+    cout << "Test3: random operations match DoublyLinkedList" << endl
+         << get_status_str(unrolled_test.test3()) << endl;
 
     return 0;
 }
@@ -174,7 +238,7 @@ int main() {
 // New empty list is valid
 bool SequentialListTest::test1() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     ASSERT_TRUE(list.size() == 0)
     ASSERT_TRUE(list.capacity() == 20)
@@ -187,8 +251,8 @@ bool SequentialListTest::test1() {
 // insert_front() and insert_back() on zero-element list
 bool SequentialListTest::test2() {
     unsigned int capacity = 5;
-    SequentialList list1(capacity);
-    SequentialList list2(capacity);
+    SequentialList<int> list1(capacity);
+    SequentialList<int> list2(capacity);
 
     ASSERT_TRUE(list1.insert_front(100))
     ASSERT_TRUE(list2.insert_back(100))
@@ -202,7 +266,7 @@ bool SequentialListTest::test2() {
 // select() and search() work properly
 bool SequentialListTest::test3() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     for (unsigned int i = 0; i < capacity; i++) {
         ASSERT_TRUE(list.insert_back(i * 100))
@@ -223,8 +287,8 @@ bool SequentialListTest::test3() {
 // remove_front() and remove_back() on one-element list
 bool SequentialListTest::test4() {
     unsigned int capacity = 5;
-    SequentialList list1(capacity);
-    SequentialList list2(capacity);
+    SequentialList<int> list1(capacity);
+    SequentialList<int> list2(capacity);
 
     ASSERT_TRUE(list1.insert_front(100))
     ASSERT_TRUE(list2.insert_front(100))
@@ -240,7 +304,7 @@ bool SequentialListTest::test4() {
 // Inserting too many elements should not fail
 bool SequentialListTest::test5() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     // Fill up the list.
     for (unsigned int i = 0; i < capacity; i++) {
@@ -265,7 +329,7 @@ bool SequentialListTest::test5() {
 // insert_front() keeps moving elements forward
 bool SequentialListTest::test6() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     for (unsigned int i = 0; i < capacity; i++) {
         ASSERT_TRUE(list.insert_front(i))
@@ -282,7 +346,7 @@ bool SequentialListTest::test6() {
 // inserting at different positions in the list succeeds
 bool SequentialListTest::test7() {
     unsigned int capacity = 10;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     for (int i = 0; i < 4; i++) {
         ASSERT_TRUE(list.insert_back(i))
@@ -307,7 +371,7 @@ bool SequentialListTest::test7() {
 bool SequentialListTest::test8() {
     unsigned int capacity = 5;
     const int num_elems = 4;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     for (int i = 0; i < num_elems; i++) {
         ASSERT_TRUE(list.insert_back(i))
@@ -333,7 +397,7 @@ bool SequentialListTest::test8() {
 // lots of inserts and deletes, all of them valid
 bool SequentialListTest::test9() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     ASSERT_TRUE(list.insert_back(32))
     ASSERT_TRUE(list.insert_front(44))
@@ -354,7 +418,7 @@ bool SequentialListTest::test9() {
 // lots of inserts and deletes, some of them invalid
 bool SequentialListTest::test10() {
     unsigned int capacity = 5;
-    SequentialList list(capacity);
+    SequentialList<int> list(capacity);
 
     ASSERT_FALSE(list.remove(0));          // Removing from an empty list, should fail
     ASSERT_TRUE(list.insert_back(32));     // Insert at back, list: [32]
@@ -377,6 +441,208 @@ bool SequentialListTest::test10() {
 }
 
 
+// strings are moved, copied and emplaced correctly
+bool SequentialListTest::test11() {
+    SequentialList<string> list(5);
+
+    // grow past the initial capacity with front inserts, so every shift moves strings
+    for (int i = 0; i < 50; i++) {
+        ASSERT_TRUE(list.insert_front("member" + to_string(i)))
+    }
+    ASSERT_TRUE(list.emplace(25, 3, 'x'))          // list[25] = "xxx"
+    ASSERT_TRUE(list.emplace_back(list[0]))        // copies an element of the list itself
+    ASSERT_TRUE(list.size() == 52 && list.capacity() == 80)
+    ASSERT_TRUE(list[0] == "member49" && list[24] == "member25" && list[25] == "xxx" && list[26] == "member24")
+    ASSERT_TRUE(list[50] == "member0" && list[51] == "member49")
+    ASSERT_TRUE(list.search("xxx") == 25)
+    ASSERT_TRUE(list.select(52) == "")
+
+    SequentialList<string> copy(list);
+    ASSERT_TRUE(copy.replace(0, "changed") && list[0] == "member49")
+
+    SequentialList<string> moved(std::move(list));
+    ASSERT_TRUE(moved.size() == 52 && moved[25] == "xxx")
+    ASSERT_TRUE(list.size() == 0 && list.insert_back("again") && list[0] == "again")
+
+    copy = moved;
+    for (int i = 0; i < 45; i++) {
+        ASSERT_TRUE(moved.remove_front())
+    }
+    ASSERT_TRUE(moved.size() == 7 && moved.capacity() == 20)
+    ASSERT_TRUE(moved[0] == "member5" && moved[6] == "member49")
+    ASSERT_TRUE(copy.size() == 52 && copy[0] == "member49")
+    ASSERT_FALSE(moved.replace(7, "past the end"))
+
+    return true;
+}
+
+// range inserts and removes, reserve() and shrink_to_fit()
+bool SequentialListTest::test12() {
+    SequentialList<int> list(5);
+    int values[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+
+    ASSERT_TRUE(list.append_range(values, values + 3))      // list: [10, 11, 12]
+    ASSERT_TRUE(list.insert_range(1, values + 5, values + 10))
+    int expected_values[] = {10, 15, 16, 17, 18, 19, 11, 12};
+    ASSERT_TRUE(list.size() == 8)
+    for (unsigned int i = 0; i < list.size(); i++) {
+        ASSERT_TRUE(list.select(i) == expected_values[i])
+    }
+    ASSERT_FALSE(list.insert_range(9, values, values + 1))   // past the end
+    ASSERT_TRUE(list.insert_range(8, values, values))        // empty range
+
+    // 100 more at the front: one reallocation straight to 160
+    SequentialList<int> more(5);
+    for (int i = 0; i < 100; i++) more.insert_back(i);
+    ASSERT_TRUE(list.insert_range(0, &more[0], &more[0] + more.size()))
+    ASSERT_TRUE(list.size() == 108 && list.capacity() == 160)
+    ASSERT_TRUE(list.select(99) == 99 && list.select(100) == 10 && list.select(107) == 12)
+
+    ASSERT_FALSE(list.remove_range(5, 4))
+    ASSERT_FALSE(list.remove_range(100, 109))
+    ASSERT_TRUE(list.remove_range(1, 101))                   // list: [0, 15, 16, 17, 18, 19, 11, 12]
+    ASSERT_TRUE(list.size() == 8 && list.capacity() == 20)
+    ASSERT_TRUE(list.select(0) == 0 && list.select(1) == 15 && list.select(7) == 12)
+
+    list.reserve(500);
+    ASSERT_TRUE(list.capacity() == 500 && list.select(7) == 12)
+    list.reserve(10);
+    ASSERT_TRUE(list.capacity() == 500)
+    list.shrink_to_fit();
+    ASSERT_TRUE(list.capacity() == 20 && list.size() == 8)
+
+    SequentialList<string> names(5);
+    string more_names[] = {"ann", "bob", "cat"};
+    ASSERT_TRUE(names.append_range(more_names, more_names + 3))
+    ASSERT_TRUE(names.insert_range(1, more_names, more_names + 3))
+    ASSERT_TRUE(names.remove_range(0, 2))                    // names: [bob, cat, bob, cat]
+    ASSERT_TRUE(names.size() == 4 && names[0] == "bob" && names[3] == "cat")
+
+    // a copy that throws halfway through leaves the list as it was
+    {
+        Fragile sources[] = {"x", "y", "z"};
+        SequentialList<Fragile> fragile(5);
+        fragile.emplace_back("a");
+        fragile.emplace_back("b");
+        fragile.emplace_back("c");
+        Fragile::copies_left = 1;
+        bool threw = false;
+        try {
+            fragile.insert_range(1, sources, sources + 3);
+        } catch (const runtime_error&) {
+            threw = true;
+        }
+        ASSERT_TRUE(threw)
+        ASSERT_TRUE(fragile.size() == 3 && Fragile::live == 6)
+        ASSERT_TRUE(fragile[0].name == "a" && fragile[1].name == "b" && fragile[2].name == "c")
+        Fragile::copies_left = 3;
+        ASSERT_TRUE(fragile.insert_range(3, sources, sources + 3))
+        ASSERT_TRUE(fragile.size() == 6 && fragile[5].name == "z" && Fragile::live == 9)
+    }
+    ASSERT_TRUE(Fragile::live == 0)
+
+    return true;
+}
+
+// capacity policy and reallocation counters
+bool SequentialListTest::test13() {
+    // the default policy doubles from 20: three reallocations up to 160
+    SequentialList<int> list(5);
+    for (int i = 0; i < 150; i++) {
+        ASSERT_TRUE(list.insert_back(i))
+    }
+    ASSERT_TRUE(list.capacity() == 160)
+    ASSERT_TRUE(list.capacity_stats().grows == 3 && list.capacity_stats().shrinks == 0)
+    ASSERT_TRUE(list.capacity_stats().bytes_copied == (20 + 40 + 80) * sizeof(int))
+
+    // going back and forth between 17 and 21 elements: the default policy
+    // shrinks only below 10, but one that shrinks below 45% full
+    // reallocates twice per round trip unless a cooldown holds it back
+    SequentialList<int> halves(5);
+    SequentialList<int> eager(5, CapacityPolicy(2.0, 0.45));
+    SequentialList<int> calm(5, CapacityPolicy(2.0, 0.45, 64));
+    SequentialList<int>* lists[] = {&halves, &eager, &calm};
+    for (SequentialList<int>* l : lists) {
+        for (int i = 0; i < 21; i++) l->insert_back(i);
+        for (int round = 0; round < 100; round++) {
+            for (int i = 0; i < 4; i++) l->remove_back();
+            for (int i = 0; i < 4; i++) l->insert_back(i);
+        }
+        ASSERT_TRUE(l->size() == 21 && l->select(20) == 3)
+    }
+    ASSERT_TRUE(halves.capacity_stats().reallocations() == 1)
+    ASSERT_TRUE(eager.capacity_stats().reallocations() == 201)
+    ASSERT_TRUE(calm.capacity_stats().reallocations() < 20)
+
+    // a minimum capacity applies from the start
+    SequentialList<int> big(5, CapacityPolicy(2.0, 0.25, 0, 100));
+    ASSERT_TRUE(big.capacity() == 100)
+    big.shrink_to_fit();
+    ASSERT_TRUE(big.capacity() == 100)
+
+    return true;
+}
+
+// search, count, min, max and range scans
+bool SequentialListTest::test14() {
+    SequentialList<int> empty(5);
+    ASSERT_TRUE(empty.search(3) == 0 && empty.count(3) == 0)
+    ASSERT_TRUE(empty.min() == -999 && empty.max() == -999)
+    ASSERT_TRUE(empty.find_between(0, 10) == 0 && empty.count_between(0, 10) == 0)
+
+    // every length up to 100, so each kernel's tail gets handled, with
+    // values at both ends of the int range
+    SequentialList<int> list(5);
+    for (int n = 1; n <= 100; n++) {
+        list.insert_back((n * 37) % 101 - 50);
+        if (n == 70) list.replace(69, INT_MIN);
+        if (n == 80) list.replace(79, INT_MAX);
+
+        int last = list.select(n - 1);
+        ASSERT_TRUE(list.search(last) == list.find_if([last](int x) { return x == last; }))
+        ASSERT_TRUE(list.search(1000) == (unsigned int)n)
+        ASSERT_TRUE(list.find_between(48, 50) == list.find_if([](int x) { return 48 <= x && x <= 50; }))
+        ASSERT_TRUE(list.find_between(50, 48) == (unsigned int)n)
+        ASSERT_TRUE(list.count_between(INT_MIN, INT_MAX) == (unsigned int)n)
+        ASSERT_TRUE(list.min() == (n >= 70 ? INT_MIN : simd_scan::min_scalar(&list[0], n)))
+        ASSERT_TRUE(list.max() == (n >= 80 ? INT_MAX : simd_scan::max_scalar(&list[0], n)))
+    }
+
+    // the same answers from the plain loops and from each vector kernel
+    // this CPU has
+    for (int l = simd_scan::SCALAR; l <= simd_scan::AVX2; l++) {
+        simd_scan::Level level = (simd_scan::Level)l;
+        if (!simd_scan::supported(level)) continue;
+        simd_scan::Kernels k = simd_scan::kernels_for(level);
+        for (unsigned int n = 0; n <= 100; n++) {
+            const int* data = &list[0] + (100 - n);   // ends at the last element
+            ASSERT_TRUE(k.find(data, n, 7) == simd_scan::find_scalar(data, n, 7))
+            ASSERT_TRUE(k.count(data, n, 7) == simd_scan::count_scalar(data, n, 7))
+            ASSERT_TRUE(k.find_between(data, n, -5, 5) == simd_scan::find_between_scalar(data, n, -5, 5))
+            ASSERT_TRUE(k.count_between(data, n, -5, 5) == simd_scan::count_between_scalar(data, n, -5, 5))
+            if (n > 0) {
+                ASSERT_TRUE(k.min(data, n) == simd_scan::min_scalar(data, n))
+                ASSERT_TRUE(k.max(data, n) == simd_scan::max_scalar(data, n))
+            }
+        }
+    }
+
+    // a value that repeats: count all, search finds the first
+    SequentialList<int> sevens(5);
+    for (int i = 0; i < 300; i++) sevens.insert_back(i % 3 == 0 ? 7 : i);
+    ASSERT_TRUE(sevens.count(7) == 101 && sevens.search(7) == 0)
+    ASSERT_TRUE(sevens.count_between(290, 300) == 7)
+
+    SequentialList<string> names(5);
+    string more_names[] = {"cat", "ann", "bob", "ann"};
+    names.append_range(more_names, more_names + 4);
+    ASSERT_TRUE(names.search("bob") == 2 && names.count("ann") == 2)
+    ASSERT_TRUE(names.min() == "ann" && names.max() == "cat")
+    ASSERT_TRUE(names.find_between("b", "bz") == 2 && names.count_between("a", "b") == 2)
+
+    return true;
+}
+
 
 //############# DoublyLinkedListTest function definitions ###########
 
@@ -591,6 +857,52 @@ bool DoublyLinkedListTest::test11() {
     return true;
 }
 
+// Nodes come from the pool and are reused
+bool DoublyLinkedListTest::test12() {
+    DoublyLinkedList list;
+    ASSERT_TRUE(list.pool_stats().chunks == 0);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(list.insert_back(i));
+    }
+    const NodePoolStats& stats = list.pool_stats();
+    ASSERT_TRUE(stats.live == 1000 && stats.reused == 0);
+    ASSERT_TRUE(stats.chunks >= 2 && stats.chunks <= 4);
+    unsigned long long chunks = stats.chunks;
+
+    // nodes created one after another are next to each other
+    DoublyLinkedList::Node* node = list.head_;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(node->next == node + 1);
+        node = node->next;
+    }
+
+    // churn at both ends and in the middle reuses slots, never the heap
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 10; i++) {
+            ASSERT_TRUE(list.remove_front());
+            ASSERT_TRUE(list.remove_back());
+            ASSERT_TRUE(list.remove(400));
+        }
+        for (int i = 0; i < 10; i++) {
+            ASSERT_TRUE(list.insert_back(2000 + i));
+            ASSERT_TRUE(list.insert_front(-i));
+            ASSERT_TRUE(list.insert(3000 + i, 400));
+        }
+    }
+    ASSERT_TRUE(stats.live == 1000 && stats.reused == 50 * 30);
+    ASSERT_TRUE(stats.chunks == chunks);
+    ASSERT_TRUE(list.select(0) == -9 && list.select(999) == 2009);
+    ASSERT_TRUE(list.select(400) == 3009);
+
+    while (!list.empty()) {
+        ASSERT_TRUE(list.remove_back());
+    }
+    ASSERT_TRUE(stats.live == 0);
+    ASSERT_TRUE(list.insert_back(7) && list.select(0) == 7);
+    return true;
+}
+
 // Regular functionality test mimicking a user's actions
 bool DoublyLinkedListTest::regularFunctionalityTest() {
     DoublyLinkedList list;
@@ -635,3 +947,150 @@ bool DoublyLinkedListTest::regularFunctionalityTest() {
 
     return true;
 }
+
+
+//############# UnrolledLinkedListTest function definitions ###########
+
+bool UnrolledLinkedListTest::checkNodes(const UnrolledLinkedList& list) {
+    unsigned int total = 0;
+    UnrolledLinkedList::Node* prev = nullptr;
+    for (UnrolledLinkedList::Node* node = list.head_; node != nullptr; node = node->next) {
+        ASSERT_TRUE(node->prev == prev)
+        ASSERT_TRUE(node->count > 0 && node->count <= UnrolledLinkedList::NODE_CAPACITY)
+        total += node->count;
+        prev = node;
+    }
+    ASSERT_TRUE(list.tail_ == prev)
+    ASSERT_TRUE(total == list.size())
+    return true;
+}
+
+// Regular functionality test mimicking a user's actions
+bool UnrolledLinkedListTest::test1() {
+    UnrolledLinkedList list;
+    ASSERT_TRUE(list.empty() && !list.full() && list.capacity() == 65536)
+    ASSERT_TRUE(list.select(0) == -999)
+    ASSERT_FALSE(list.remove_front())
+    ASSERT_FALSE(list.remove_back())
+
+    ASSERT_TRUE(list.insert_back(10))      // [10]
+    ASSERT_TRUE(list.insert_front(20))     // [20, 10]
+    ASSERT_TRUE(list.insert(30, 1))        // [20, 30, 10]
+    ASSERT_TRUE(list.select(0) == 20 && list.select(1) == 30 && list.select(2) == 10)
+    ASSERT_TRUE(list.select(3) == 10)      // out of bounds: the last element
+
+    ASSERT_TRUE(list.replace(1, 40))       // [20, 40, 10]
+    ASSERT_TRUE(list.select(1) == 40)
+    ASSERT_TRUE(list.search(40) == 1 && list.search(50) == list.size())
+
+    ASSERT_TRUE(list.remove_front())       // [40, 10]
+    ASSERT_TRUE(list.remove_back())        // [40]
+    ASSERT_TRUE(list.remove(0))            // []
+    ASSERT_TRUE(list.empty() && list.head_ == nullptr && list.tail_ == nullptr)
+    ASSERT_FALSE(list.replace(0, 50))
+    ASSERT_FALSE(list.insert(60, 1))
+    ASSERT_TRUE(list.insert(50, 0) && list.size() == 1 && list.select(0) == 50)
+
+    // fill to capacity
+    while (!list.full()) {
+        ASSERT_TRUE(list.insert_back((int)list.size()))
+    }
+    ASSERT_FALSE(list.insert_back(0))
+    ASSERT_TRUE(list.select(65535) == 65535 && list.search(40000) == 40000)
+    ASSERT_TRUE(checkNodes(list))
+    return true;
+}
+
+// nodes split when full and merge when under half full
+bool UnrolledLinkedListTest::test2() {
+    const unsigned int cap = UnrolledLinkedList::NODE_CAPACITY;
+    ASSERT_TRUE(sizeof(UnrolledLinkedList::Node) == 128)
+
+    // appending fills each node before starting the next
+    UnrolledLinkedList list;
+    for (unsigned int i = 0; i < 3 * cap; i++) {
+        ASSERT_TRUE(list.insert_back(i))
+    }
+    ASSERT_TRUE(list.pool_stats().live == 3)
+    ASSERT_TRUE(list.head_->count == cap && list.tail_->count == cap)
+
+    // inserting into a full middle node splits it
+    ASSERT_TRUE(list.insert(-1, cap + 5))
+    ASSERT_TRUE(list.pool_stats().live == 4 && checkNodes(list))
+    ASSERT_TRUE(list.head_->next->count == cap / 2 + 1)
+    ASSERT_TRUE(list.select(cap + 5) == -1 && list.select(cap + 6) == (int)cap + 5)
+
+    // so does prepending, without touching the full head
+    ASSERT_TRUE(list.insert_front(-2))
+    ASSERT_TRUE(list.pool_stats().live == 5 && list.head_->count == 1)
+    ASSERT_TRUE(list.head_->next->count == cap)
+
+    // removing from the front merges the head into its neighbours
+    for (unsigned int i = 0; i < cap + 2; i++) {
+        ASSERT_TRUE(list.remove_front())
+        ASSERT_TRUE(checkNodes(list))
+    }
+    ASSERT_TRUE(list.select(0) == (int)cap + 1)
+    ASSERT_TRUE(list.pool_stats().live == 3)
+
+    // removing every other element leaves nodes at least half full
+    for (unsigned int i = 0; i < list.size(); i++) {
+        ASSERT_TRUE(list.remove(i))
+    }
+    ASSERT_TRUE(checkNodes(list))
+    for (UnrolledLinkedList::Node* node = list.head_; node != list.tail_; node = node->next) {
+        ASSERT_TRUE(node->count >= UnrolledLinkedList::MIN_FILL)
+    }
+    while (list.remove_back()) {
+        ASSERT_TRUE(checkNodes(list))
+    }
+    ASSERT_TRUE(list.pool_stats().live == 0 && list.head_ == nullptr)
+    return true;
+}
+
+// random operations match DoublyLinkedList
+bool UnrolledLinkedListTest::test3() {
+    UnrolledLinkedList list;
+    DoublyLinkedList expected;
+    unsigned int seed = 12345;
+
+    for (int step = 0; step < 20000; step++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+        unsigned int size = expected.size();
+        int value = (int)(r % 1000);
+        // grow for the first half, shrink for the second
+        unsigned int op = r % (step < 10000 ? 10 : 14);
+
+        if (op < 4) {
+            unsigned int index = (r / 16) % (size + 2);
+            ASSERT_TRUE(list.insert(value, index) == expected.insert(value, index))
+        } else if (op < 6) {
+            ASSERT_TRUE(list.insert_front(value) && expected.insert_front(value))
+        } else if (op < 8) {
+            ASSERT_TRUE(list.insert_back(value) && expected.insert_back(value))
+        } else if (op < 9) {
+            unsigned int index = (r / 16) % (size + 1);
+            ASSERT_TRUE(list.replace(index, value) == expected.replace(index, value))
+        } else if (op < 10) {
+            ASSERT_TRUE(list.search(value) == expected.search(value))
+        } else if (op < 12) {
+            unsigned int index = (r / 16) % (size + 1);
+            ASSERT_TRUE(list.remove(index) == expected.remove(index))
+        } else if (op < 13) {
+            ASSERT_TRUE(list.remove_front() == expected.remove_front())
+        } else {
+            ASSERT_TRUE(list.remove_back() == expected.remove_back())
+        }
+
+        ASSERT_TRUE(list.size() == expected.size())
+        if (step % 500 == 0) {
+            ASSERT_TRUE(checkNodes(list))
+            for (unsigned int i = 0; i < list.size(); i++) {
+                ASSERT_TRUE(list.select(i) == expected.select(i))
+            }
+        }
+    }
+    ASSERT_TRUE(checkNodes(list))
+    return true;
+}
@@ -0,0 +1,285 @@
+#include "unrolled-linked-list.h"
+#include <cstring>
+#include <type_traits>
+#include "simd-scan.h"
+
+static_assert(sizeof(UnrolledLinkedList::DataType) == sizeof(int), "search scans the values as ints");
+
+UnrolledLinkedList::Node::Node()
+    : next(nullptr), prev(nullptr), count(0) {}
+
+UnrolledLinkedList::UnrolledLinkedList()
+    : head_(nullptr), tail_(nullptr), size_(0) {}
+
+UnrolledLinkedList::~UnrolledLinkedList() {
+    // The pool frees every node when it is destroyed.
+    static_assert(std::is_trivially_destructible<Node>::value, "nodes are freed without being destroyed");
+    static_assert(sizeof(Node) == NODE_BYTES, "a node is NODE_BYTES");
+    head_ = tail_ = nullptr;
+}
+
+
+unsigned int UnrolledLinkedList::size() const {
+    return size_;
+}
+
+
+unsigned int UnrolledLinkedList::capacity() const {
+    return CAPACITY;
+}
+
+
+bool UnrolledLinkedList::empty() const {
+    return size_ == 0;
+}
+
+
+bool UnrolledLinkedList::full() const {
+    return size_ == CAPACITY;
+}
+
+
+const NodePoolStats& UnrolledLinkedList::pool_stats() const {
+    return pool_.stats();
+}
+
+
+UnrolledLinkedList::DataType UnrolledLinkedList::select(unsigned int index) const {
+    // List is empty, return sentinel value
+    if (size_ == 0) return DataType(-999);
+
+    // Index out of bounds, return the last element
+    if (index >= size_) return tail_->values[tail_->count - 1];
+
+    unsigned int offset;
+    Node* node = getNode(index, offset);
+    return node->values[offset];
+}
+
+
+unsigned int UnrolledLinkedList::search(DataType value) const {
+    const simd_scan::Kernels& kernels = simd_scan::kernels();
+    unsigned int index = 0;
+
+    // Scan each node's values, keeping count of the elements passed
+    for (Node* node = head_; node != nullptr; node = node->next) {
+        unsigned int found = kernels.find(node->values, node->count, value);
+        if (found < node->count) return index + found;
+        index += node->count;
+    }
+
+    // Value not found, return size_ as an indicator
+    return size_;
+}
+
+
+void UnrolledLinkedList::print() const {
+    for (Node* node = head_; node != nullptr; node = node->next) {
+        for (unsigned int i = 0; i < node->count; ++i) {
+            std::cout << node->values[i];
+            if (i + 1 < node->count || node->next != nullptr) {
+                std::cout << " <-> ";
+            }
+        }
+    }
+    std::cout << " -> nullptr" << std::endl;
+}
+
+
+UnrolledLinkedList::Node* UnrolledLinkedList::getNode(unsigned int index, unsigned int& offset) const {
+    // Index out of bounds
+    if (index >= size_) return nullptr;
+
+    Node* current;
+
+    // Skip whole nodes from the closer end
+    if (index < size_ / 2) {
+        current = head_;
+        while (index >= current->count) {
+            index -= current->count;
+            current = current->next;
+        }
+        offset = index;
+    } else {
+        unsigned int fromEnd = size_ - 1 - index;
+        current = tail_;
+        while (fromEnd >= current->count) {
+            fromEnd -= current->count;
+            current = current->prev;
+        }
+        offset = current->count - 1 - fromEnd;
+    }
+
+    return current;
+}
+
+
+UnrolledLinkedList::Node* UnrolledLinkedList::linkAfter(Node* node) {
+    Node* newNode = pool_.create();
+    newNode->prev = node;
+    newNode->next = node->next;
+    if (node->next != nullptr) node->next->prev = newNode;
+    else tail_ = newNode;
+    node->next = newNode;
+    return newNode;
+}
+
+
+UnrolledLinkedList::Node* UnrolledLinkedList::linkBefore(Node* node) {
+    Node* newNode = pool_.create();
+    newNode->next = node;
+    newNode->prev = node->prev;
+    if (node->prev != nullptr) node->prev->next = newNode;
+    else head_ = newNode;
+    node->prev = newNode;
+    return newNode;
+}
+
+
+void UnrolledLinkedList::unlink(Node* node) {
+    if (node->prev != nullptr) node->prev->next = node->next;
+    else head_ = node->next;
+    if (node->next != nullptr) node->next->prev = node->prev;
+    else tail_ = node->prev;
+    pool_.destroy(node);
+}
+
+
+void UnrolledLinkedList::split(Node* node) {
+    Node* upper = linkAfter(node);
+    unsigned int keep = node->count / 2;
+    upper->count = node->count - keep;
+    std::memcpy(upper->values, node->values + keep, upper->count * sizeof(DataType));
+    node->count = keep;
+}
+
+
+void UnrolledLinkedList::rebalance(Node* node) {
+    if (node->count >= MIN_FILL) return;
+
+    Node* next = node->next;
+    Node* prev = node->prev;
+
+    // Merge the next node into this one
+    if (next != nullptr && node->count + next->count <= NODE_CAPACITY) {
+        std::memcpy(node->values + node->count, next->values, next->count * sizeof(DataType));
+        node->count += next->count;
+        unlink(next);
+    }
+    // Merge this node into the previous one
+    else if (prev != nullptr && prev->count + node->count <= NODE_CAPACITY) {
+        std::memcpy(prev->values + prev->count, node->values, node->count * sizeof(DataType));
+        prev->count += node->count;
+        unlink(node);
+    }
+    // Take half the difference from the front of the next node
+    else if (next != nullptr) {
+        unsigned int moved = (next->count - node->count) / 2;
+        std::memcpy(node->values + node->count, next->values, moved * sizeof(DataType));
+        std::memmove(next->values, next->values + moved, (next->count - moved) * sizeof(DataType));
+        node->count += moved;
+        next->count -= moved;
+    }
+    // Take half the difference from the back of the previous node
+    else if (prev != nullptr) {
+        unsigned int moved = (prev->count - node->count) / 2;
+        std::memmove(node->values + moved, node->values, node->count * sizeof(DataType));
+        std::memcpy(node->values, prev->values + prev->count - moved, moved * sizeof(DataType));
+        node->count += moved;
+        prev->count -= moved;
+    }
+    // The only node, now empty
+    else if (node->count == 0) {
+        unlink(node);
+    }
+}
+
+
+bool UnrolledLinkedList::insert(DataType value, unsigned int index) {
+    // Index out of bounds or list at capacity
+    if (index > size_ || size_ >= CAPACITY) return false;
+
+    // Inserting into an empty list
+    if (head_ == nullptr) {
+        head_ = tail_ = pool_.create();
+    }
+
+    Node* node;
+    unsigned int offset;
+    if (index == size_) {
+        node = tail_;
+        offset = tail_->count;
+    } else {
+        node = getNode(index, offset);
+    }
+
+    if (node->count == NODE_CAPACITY) {
+        // Appending to a full tail: start a new tail
+        if (offset == NODE_CAPACITY && node == tail_) {
+            node = linkAfter(node);
+            offset = 0;
+        }
+        // Prepending to a full head: start a new head
+        else if (offset == 0 && node == head_) {
+            node = linkBefore(node);
+        }
+        // Otherwise split, and insert into the half the index falls in
+        else {
+            split(node);
+            if (offset > node->count) {
+                offset -= node->count;
+                node = node->next;
+            }
+        }
+    }
+
+    std::memmove(node->values + offset + 1, node->values + offset, (node->count - offset) * sizeof(DataType));
+    node->values[offset] = value;
+    node->count++;
+    size_++;
+    return true;
+}
+
+
+bool UnrolledLinkedList::insert_front(DataType value) {
+    return insert(value, 0);
+}
+
+
+bool UnrolledLinkedList::insert_back(DataType value) {
+    return insert(value, size_);
+}
+
+
+bool UnrolledLinkedList::remove(unsigned int index) {
+    // Check if index is out of bounds or list is empty
+    if (index >= size_) return false;
+
+    unsigned int offset;
+    Node* node = getNode(index, offset);
+    std::memmove(node->values + offset, node->values + offset + 1, (node->count - offset - 1) * sizeof(DataType));
+    node->count--;
+    size_--;
+
+    rebalance(node);
+    return true;
+}
+
+
+bool UnrolledLinkedList::remove_front() {
+    return remove(0);
+}
+
+
+bool UnrolledLinkedList::remove_back() {
+    return remove(size_ - 1);
+}
+
+
+bool UnrolledLinkedList::replace(unsigned int index, DataType value) {
+    if (index >= size_) return false;
+    unsigned int offset;
+    Node* node = getNode(index, offset);
+    node->values[offset] = value;
+    return true;
+}
@@ -0,0 +1,152 @@
+#ifndef LAB1_UNROLLED_LINKED_LIST_H
+#define LAB1_UNROLLED_LINKED_LIST_H
+
+#include <iostream>
+#include <limits.h>
+#include "node-pool.h"
+
+// A doubly linked list that keeps a small array of elements in each node,
+// with the same interface as DoublyLinkedList.
+//
+// A node is two cache lines: its links, a count, and up to NODE_CAPACITY
+// elements (27 ints on a 64-bit machine), so a walk follows one pointer per
+// node instead of per element. Inserting into a full node splits it in two
+// halves; appending to a full tail or prepending to a full head starts a new
+// node instead, so lists built at either end stay packed. A node that falls
+// below half full after a removal merges with a neighbour if they fit in one
+// node, or otherwise takes elements from one. Nodes come from a NodePool.
+class UnrolledLinkedList {
+public:
+    // Can be seen outside as UnrolledLinkedList::DataType
+    typedef int DataType;
+
+
+private:
+    // Befriend so tests have access to variables.
+    friend class UnrolledLinkedListTest;
+
+
+    // The same capacity as DoublyLinkedList.
+    static const unsigned int CAPACITY = 65536;
+
+    // Size of a node: two cache lines.
+    static const unsigned int NODE_BYTES = 128;
+
+    // Elements per node: what is left of NODE_BYTES after the links and count.
+    static const unsigned int NODE_CAPACITY = (NODE_BYTES - 2 * sizeof(void*) - sizeof(unsigned int)) / sizeof(DataType);
+
+    // A node below this many elements after a removal merges or borrows.
+    static const unsigned int MIN_FILL = NODE_CAPACITY / 2;
+
+
+    // The node structure used for the UnrolledLinkedList.
+    struct alignas(64) Node {
+        Node();
+        Node* next;
+        Node* prev;
+        unsigned int count;
+        DataType values[NODE_CAPACITY];
+    };
+
+
+    // Returns the node that holds the element at index, and sets offset to
+    // its position in that node. Walks from the closer end of the list.
+    Node* getNode(unsigned int index, unsigned int& offset) const;
+
+    // Link a new, empty node after / before the given one.
+    Node* linkAfter(Node* node);
+    Node* linkBefore(Node* node);
+
+    // Unlinks a node and frees it.
+    void unlink(Node* node);
+
+    // Moves the upper half of a full node into a new node after it.
+    void split(Node* node);
+
+    // After a removal: merges a node below MIN_FILL with a neighbour, or
+    // moves elements over from one.
+    void rebalance(Node* node);
+
+
+    // MEMBER VARIABLES
+    // Where the nodes are allocated from. Declared first, so it is
+    // destroyed last.
+    NodePool<Node> pool_;
+
+    // A pointer to the head node of the list.
+    Node* head_;
+
+    // A pointer to the tail node of the list.
+    Node* tail_;
+
+    // The number of elements in the list.
+    unsigned int size_;
+
+
+public:
+    // CONSTRUCTOR/DESTRUCTOR
+    // Create a new empty UnrolledLinkedList.
+    UnrolledLinkedList();
+
+    // Destroy this UnrolledLinkedList, freeing all dynamically allocated memory.
+    ~UnrolledLinkedList();
+
+    UnrolledLinkedList(const UnrolledLinkedList& rhs) = delete;
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& rhs) = delete;
+
+
+    // ACCESSORS
+    // Returns the number of elements in the list.
+    unsigned int size() const;
+
+    // Returns the maximum number of elements the list can hold.
+    unsigned int capacity() const;
+
+    // Returns true if the list is empty, false otherwise.
+    bool empty() const;
+
+    // Returns true if the list is at capacity, false otherwise.
+    bool full() const;
+
+    // Returns what the node pool has allocated so far.
+    const NodePoolStats& pool_stats() const;
+
+    // Returns the value at the given index in the list. If index is invalid,
+    // return the value of the last element.
+    DataType select(unsigned int index) const;
+
+    // Searches for the given value, and returns the index of this value if found.
+    // returns the size of the list otherwise.
+    unsigned int search(DataType val) const;
+
+    // Prints all elements in the list to the standard output.
+    void print() const;
+
+
+    // MUTATORS
+    // NOTE: all mutators for this class are boolean functions, returning
+    // true if the call succeeds, and false if it fails
+    // Inserts a value into the list at a given index.
+    bool insert(DataType val, unsigned int index);
+
+    // Inserts a value at the beginning of the list.
+    bool insert_front(DataType val);
+
+    // Inserts a value at the end of the list.
+    bool insert_back(DataType val);
+
+    // Deletes a value from the list at the given index.
+    bool remove(unsigned int index);
+
+    // Deletes a value from the beginning of the list.
+    bool remove_front();
+
+    // Deletes a value at the end of the list.
+    bool remove_back();
+
+    // Replaces the value at the given index with the given value.
+    bool replace(unsigned int index, DataType val);
+
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <iostream>
 
 const CircularQueue::QueueItem CircularQueue::EMPTY_QUEUE = -999;
+const unsigned int CircularQueue::MIN_CAPACITY;
 
 CircularQueue::CircularQueue() {
     capacity_ = 16;
@@ -11,8 +12,8 @@ CircularQueue::CircularQueue() {
     size_ = 0;
 }
 
-CircularQueue::CircularQueue(unsigned int capacity) {
-    capacity < 16 ? capacity_ = 16 : capacity_ = capacity;
+CircularQueue::CircularQueue(unsigned int capacity, const CapacityPolicy& policy) : policy_(policy) {
+    capacity_ = capacity < policy_.floor(MIN_CAPACITY) ? policy_.floor(MIN_CAPACITY) : capacity;
     items_ = new QueueItem[capacity_];
     head_ = 0;
     tail_ = 0;
@@ -23,41 +24,38 @@ CircularQueue::~CircularQueue() {
     delete[] items_;
 }
 
-void CircularQueue::resize() {
-    QueueItem* newQueue = new QueueItem[capacity_ * 2];
+void CircularQueue::reallocate(unsigned int capacity) {
+    // create a new queue
+    QueueItem* newQueue = new QueueItem[capacity];
 
+    // copy elements over, front first
     unsigned int index = head_;
     for (unsigned int i = 0; i < size_; ++i) {
         newQueue[i] = items_[index];
-        index++;
         index = (index + 1) % capacity_;
     }
 
     delete[] items_;
     items_ = newQueue;
     head_ = 0;
-    tail_ = size_;
-    capacity_ *= 2;
+    tail_ = size_ % capacity;
+    policy_.record_resize(capacity > capacity_, sizeof(QueueItem) * size_);
+    capacity_ = capacity;
 }
 
-void CircularQueue::shrink() {
-    if (capacity_ <= 16) return;
+void CircularQueue::resize() {
+    reallocate(policy_.grow_to(capacity_, capacity_ + 1));
+}
 
-    // create a new queue
-    QueueItem* newQueue = new QueueItem[capacity_ / 2];
+void CircularQueue::shrink() {
+    unsigned int floor = policy_.floor(MIN_CAPACITY);
+    if (capacity_ <= floor || size_ > policy_.shrink_to(capacity_, floor)) return;
 
-    // copy elements over
-    unsigned int index = head_;
-    for (unsigned int i = 0; i < size_; ++i) {
-        newQueue[i] = items_[index];
-        index = (index + 1) % capacity_;
-    }
+    reallocate(policy_.shrink_to(capacity_, floor));
+}
 
-    delete[] items_;
-    items_ = newQueue;
-    head_ = 0;
-    tail_ = size_;
-    capacity_ /= 2;
+const CapacityStats& CircularQueue::capacity_stats() const {
+    return policy_.stats();
 }
 
 unsigned int CircularQueue::size() const {
@@ -95,7 +93,7 @@ CircularQueue::QueueItem CircularQueue::dequeue() {
     head_ = (head_ + 1) % capacity_;
     size_--;
 
-    if (size_ > 0 && size_ <= capacity_ / 4) {
+    if (policy_.should_shrink(size_, capacity_, policy_.floor(MIN_CAPACITY))) {
         shrink();
     }
 
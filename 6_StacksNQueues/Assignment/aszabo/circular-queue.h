@@ -1,6 +1,8 @@
 #ifndef LAB2_CIRCULAR_QUEUE_H
 #define LAB2_CIRCULAR_QUEUE_H
 
+#include "capacity-policy.h"
+
 class CircularQueue {
 public:
     // Defines the kind of data that the queue will contain.
@@ -30,6 +32,16 @@ private:
     // Current number of items in the queue.
     unsigned int size_; 
 
+    // When to grow and shrink, and what it has cost.
+    CapacityPolicy policy_;
+
+    // The queue never shrinks below this capacity, or below the policy's
+    // minimum capacity if that is larger.
+    static const unsigned int MIN_CAPACITY = 16;
+
+    // Copies the items, front first, to a new array of the given capacity.
+    void reallocate(unsigned int capacity);
+
 
     // Copy constructor. Declared private so we don't use it incorrectly.
     CircularQueue(const CircularQueue& other) {}
@@ -47,19 +59,19 @@ public:
     CircularQueue();
 
     // Parametric constructor of the class CircularQueue. It allocates
-    // the required memory space for the queue of the given capacity.
-    // The function appropriately initializes the fields of the created
-    // empty queue.
-    CircularQueue(unsigned int capacity);
+    // the required memory space for the queue of the given capacity
+    // (at least 16, or the policy's minimum capacity). The function
+    // appropriately initializes the fields of the created empty queue.
+    CircularQueue(unsigned int capacity, const CapacityPolicy& policy = CapacityPolicy());
 
     // Destructor of the class CircularQueue. It deallocates the memory
     // space allocated for the queue.
     ~CircularQueue();
 
-    // Increase of the queue
+    // Increase of the queue, by the policy's growth factor
     void resize();
 
-    // Decrease size of queue
+    // Decrease size of queue, by the policy's growth factor
     void shrink();
 
     // ACCESSORS
@@ -77,6 +89,10 @@ public:
     // constant instead.
     QueueItem peek() const;
 
+    // Returns how many times the queue has reallocated, and how many bytes
+    // that copied.
+    const CapacityStats& capacity_stats() const;
+
     // MUTATORS
     // Takes as an argument a QueueItem value. If the queue is not at capacity,
     // it inserts the value at the rear of the queue after the last item, and
@@ -84,8 +100,10 @@ public:
     // returns false.
     bool enqueue(QueueItem value);
 
-    // Removes the item from the front of the queue and returns it. If the queue
-    // is empty, it returns the EMPTY_QUEUE constant instead.
+    // Removes the item from the front of the queue and returns it, shrinking
+    // the queue once it is less than a quarter full (the policy's shrink
+    // threshold). If the queue is empty, it returns the EMPTY_QUEUE constant
+    // instead.
     QueueItem dequeue();
 
     // Prints the queue items sequentially and in order, from the front
@@ -11,9 +11,9 @@ DynamicStack::DynamicStack() {
     size_ = 0;
 }
 
-// Constructor initializes stack with a user-defined capacity
-DynamicStack::DynamicStack(unsigned int capacity) {
-    init_capacity_ = capacity;
+// Constructor initializes stack with a user-defined capacity and policy
+DynamicStack::DynamicStack(unsigned int capacity, const CapacityPolicy& policy) : policy_(policy) {
+    init_capacity_ = policy_.floor(capacity);
     capacity_ = init_capacity_;
     items_ = new StackItem[capacity_];
     size_ = 0;
@@ -40,18 +40,29 @@ DynamicStack::StackItem DynamicStack::peek() const {
     return items_[size_ - 1];
 }
 
+// Returns the reallocation counters
+const CapacityStats& DynamicStack::capacity_stats() const {
+    return policy_.stats();
+}
+
+// Copies the items to a new array of the given capacity
+void DynamicStack::reallocate(unsigned int capacity) {
+    StackItem* newStack = new StackItem[capacity];
+    for (unsigned int i = 0; i < size_; ++i) {
+        newStack[i] = items_[i];
+    }
+
+    delete[] items_;
+    items_ = newStack;
+    policy_.record_resize(capacity > capacity_, sizeof(StackItem) * size_);
+    capacity_ = capacity;
+}
+
 // Pushes a new item onto the stack, resizing if necessary
 void DynamicStack::push(StackItem value) {
     if (size_ == capacity_) {
-        // Double the capacity if the stack is full
-        StackItem* newStack = new StackItem[capacity_ * 2];
-        for (unsigned int i = 0; i < size_; ++i) {
-            newStack[i] = items_[i];
-        }
-
-        delete[] items_;
-        items_ = newStack;
-        capacity_ *= 2;
+        // Grow the capacity (double it, by default) if the stack is full
+        reallocate(policy_.grow_to(capacity_, size_ + 1));
     }
 
     items_[size_] = value;
@@ -62,20 +73,14 @@ void DynamicStack::push(StackItem value) {
 DynamicStack::StackItem DynamicStack::pop() {
     if (empty()) return EMPTY_STACK;
 
-    // Shrink the capacity if the size is less than a quarter of the capacity and greater than initial capacity
-    if (size_ < capacity_ / 4 && capacity_ > init_capacity_) {
-        StackItem* newStack = new StackItem[capacity_ / 2];
-        for (unsigned int i = 0; i < size_; ++i) {
-            newStack[i] = items_[i];
-        }
+    StackItem popped = items_[size_ - 1];
+    size_--;
 
-        delete[] items_;
-        items_ = newStack;
-        capacity_ /= 2;
+    // Shrink the capacity if the size left is less than a quarter of the capacity and greater than initial capacity
+    if (policy_.should_shrink(size_, capacity_, init_capacity_)) {
+        reallocate(policy_.shrink_to(capacity_, init_capacity_));
     }
 
-    StackItem popped = items_[size_ - 1];
-    size_--;
     return popped;
 }
 
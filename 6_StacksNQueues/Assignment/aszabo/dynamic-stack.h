@@ -1,6 +1,8 @@
 #ifndef LAB2_DYNAMIC_STACK_H
 #define LAB2_DYNAMIC_STACK_H
 
+#include "capacity-policy.h"
+
 class DynamicStack {
 public:
     // Defines the kind of data that the stack will contain
@@ -29,6 +31,12 @@ private:
     // This is used by pop() to determine if we should decrease the capacity.
     unsigned int init_capacity_;
 
+    // When to grow and shrink, and what it has cost.
+    CapacityPolicy policy_;
+
+    // Moves the items to a new array of the given capacity.
+    void reallocate(unsigned int capacity);
+
 
     // Copy constructor. Declared private so we don't use it incorrectly.
     DynamicStack(const DynamicStack& other) {}
@@ -46,9 +54,10 @@ public:
     DynamicStack();
 
     // Parametric constructor of the class DynamicStack. It allocates the required
-    // memory space for the stack of the given capacity. The function
-    // appropriately initializes the fields of the created empty stack.
-    DynamicStack(unsigned int capacity);
+    // memory space for the stack of the given capacity (at least the policy's
+    // minimum capacity). The function appropriately initializes the fields of
+    // the created empty stack.
+    DynamicStack(unsigned int capacity, const CapacityPolicy& policy = CapacityPolicy());
 
     // Destructor of the class DynamicStack. It deallocates the memory space
     // allocated for the stack.
@@ -66,18 +75,24 @@ public:
     // stack is empty, it returns the EMPTY_STACK constant instead.
     StackItem peek() const;
 
+    // Returns how many times the stack has reallocated, and how many bytes
+    // that copied.
+    const CapacityStats& capacity_stats() const;
+
     // MUTATORS
     // Takes as an argument a StackItem value. If the stack is not full, the value
-    // is pushed onto the stack. Otherwise, the capacity of the stack is doubled,
-    // and the item is then pushed onto the resized stack.
+    // is pushed onto the stack. Otherwise, the capacity of the stack is grown
+    // by the policy's growth factor (doubled by default), and the item is then
+    // pushed onto the resized stack.
     void push(StackItem value);
 
     // Removes and returns the top item from the stack as long as the stack is
     // not empty. If the number of items remaining in the stack after popping
-    // is less than or equal to one quarter of the capacity of the array, then
-    // the array is halved. However, if the new halved capacity is less than
-    // the initial capacity, then no resizing takes place. Finally, If the stack
-    // is empty before the pop, the EMPTY STACK constant is returned.
+    // is less than the policy's shrink threshold (one quarter by default) of
+    // the capacity of the array, then the array is shrunk by the growth factor
+    // (halved by default), though never below the initial capacity. Finally,
+    // If the stack is empty before the pop, the EMPTY STACK constant is
+    // returned.
     StackItem pop();
 
     // Prints the stack items sequentially and in order, from the top to the
@@ -30,8 +30,8 @@ string get_status_str(bool status) {
 // Define the test suites (implementation below).
 class DynamicStackTest {
 private:
-    bool test_result[10] = {0,0,0,0,0,0,0,0,0,0};
-    string test_description[10] = {
+    bool test_result[11] = {0,0,0,0,0,0,0,0,0,0,0};
+    string test_description[11] = {
         "Test1: new empty stack is valid",
         "Test2: push() an element on zero-element stacks",
         "Test3: peek() and pop() on one-element stack",
@@ -41,7 +41,8 @@ private:
         "Test7: pop() keeps changing size and capacity",
         "Test8: try to pop() too many elements, then push() a few elements",
         "Test9: lots of push() and pop(), all of them valid",
-        "Test10: lots of push() and pop(), some of them invalid"
+        "Test10: lots of push() and pop(), some of them invalid",
+        "Test11: capacity policy and reallocation counters"
     };
     
 public:
@@ -59,12 +60,13 @@ public:
     bool test8();
     bool test9();
     bool test10();
+    bool test11();
 };
 
 class CircularQueueTest {
 private:
-    bool test_result[10] = {0,0,0,0,0,0,0,0,0,0};
-    string test_description[10] = {
+    bool test_result[11] = {0,0,0,0,0,0,0,0,0,0,0};
+    string test_description[11] = {
         "Test1: new empty queue is valid",
         "Test2: enqueue() an element on zero-element queues",
         "Test3: peek() and dequeue() on one-element queue",
@@ -74,7 +76,8 @@ private:
         "Test7: dequeue() keeps changing head",
         "Test8: try to dequeue() too many elements, then enqueue() a few elements",
         "Test9: lots of enqueue() and dequeue(), all of them valid",
-        "Test10: lots of enqueue() and dequeue(), some of them invalid"
+        "Test10: lots of enqueue() and dequeue(), some of them invalid",
+        "Test11: resizing keeps the order; capacity policy and reallocation counters"
     };
 
 public:
@@ -92,6 +95,7 @@ public:
     bool test8();
     bool test9();
     bool test10();
+    bool test11();
 };
 
 
@@ -131,7 +135,7 @@ int main() {
 //========================= Dynamic Stack Test =========================
 //======================================================================
 string DynamicStackTest::getTestDescription(int test_num) {
-    if (test_num < 1 || test_num > 10) { // check range.
+    if (test_num < 1 || test_num > 11) { // check range.
         return "";
     }
     return test_description[test_num-1];
@@ -148,12 +152,13 @@ void DynamicStackTest::runAllTests() {
     test_result[7] = test8();
     test_result[8] = test9();
     test_result[9] = test10();
+    test_result[10] = test11();
 }
 
 void DynamicStackTest::printReport() {
     cout << "  DYNAMIC STACK TEST RESULTS  \n"
          << " ^^^^^^^^^^^^^^^^^^^^^^^^^^^^ \n";
-    for (int idx = 0; idx < 10; ++idx) {
+    for (int idx = 0; idx < 11; ++idx) {
         cout << test_description[idx] << "\n  " << get_status_str(test_result[idx]) << endl << endl;
     }
     cout << endl;
@@ -411,12 +416,46 @@ bool DynamicStackTest::test10() {
     return true;
 }
 
+// Test 11: capacity policy and reallocation counters
+bool DynamicStackTest::test11() {
+    // the default policy doubles: 5 -> 10 -> 20 -> 40, then halves back
+    DynamicStack stack1(5);
+    for (int i = 0; i < 40; ++i) {
+        stack1.push(i);
+    }
+    ASSERT_TRUE(stack1.capacity_stats().grows == 3);
+    ASSERT_TRUE(stack1.capacity_stats().bytes_copied == (5 + 10 + 20) * sizeof(DynamicStack::StackItem));
+    for (int i = 39; i >= 0; --i) {
+        ASSERT_TRUE(stack1.pop() == i);
+    }
+    ASSERT_TRUE(stack1.capacity_ == 5 && stack1.capacity_stats().shrinks == 3);
+
+    // going back and forth between 13 and 17 items: a policy that shrinks
+    // below 45% full reallocates twice per round trip, unless a cooldown
+    // holds it back
+    DynamicStack eager(16, CapacityPolicy(2.0, 0.45));
+    DynamicStack calm(16, CapacityPolicy(2.0, 0.45, 64));
+    DynamicStack* stacks[] = {&eager, &calm};
+    for (DynamicStack* stack : stacks) {
+        for (int i = 0; i < 17; ++i) stack->push(i);
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 4; ++i) stack->pop();
+            for (int i = 13; i < 17; ++i) stack->push(i);
+        }
+        ASSERT_TRUE(stack->size() == 17 && stack->peek() == 16);
+    }
+    ASSERT_TRUE(eager.capacity_stats().reallocations() == 201);
+    ASSERT_TRUE(calm.capacity_stats().reallocations() < 20);
+
+    return true;
+}
+
 
 //======================================================================
 //======================== Circular Queue Test =========================
 //======================================================================
 string CircularQueueTest::getTestDescription(int test_num) {
-    if (test_num < 1 || test_num > 10) { // check range.
+    if (test_num < 1 || test_num > 11) { // check range.
         return "";
     }
     return test_description[test_num-1];
@@ -433,12 +472,13 @@ void CircularQueueTest::runAllTests() {
     test_result[7] = test8();
     test_result[8] = test9();
     test_result[9] = test10();
+    test_result[10] = test11();
 }
 
 void CircularQueueTest::printReport() {
     cout << "  CIRCULAR QUEUE TEST RESULTS  \n"
          << " ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ \n";
-    for (int idx = 0; idx < 10; ++idx) {
+    for (int idx = 0; idx < 11; ++idx) {
         cout << test_description[idx] << "\n  " << get_status_str(test_result[idx]) << endl << endl;
     }
     cout << endl;
@@ -656,4 +696,43 @@ bool CircularQueueTest::test10() {
     ASSERT_TRUE(queue.dequeue() == CircularQueue::EMPTY_QUEUE); // This should fail as queue is empty
 
     return true;
-}
\ No newline at end of file
+}
+
+// Test 11: resizing keeps the order; capacity policy and reallocation counters
+bool CircularQueueTest::test11() {
+    // wrap the queue around the end of its array, then make it grow
+    CircularQueue queue(16);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(queue.enqueue(i));
+    }
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(queue.dequeue() == i);
+    }
+    for (int i = 0; i < 40; i++) {
+        ASSERT_TRUE(queue.enqueue(i));
+    }
+    ASSERT_TRUE(queue.capacity_ == 64);
+    ASSERT_TRUE(queue.capacity_stats().grows == 2);
+    ASSERT_TRUE(queue.capacity_stats().bytes_copied == (16 + 32) * sizeof(CircularQueue::QueueItem));
+    for (int i = 0; i < 40; i++) {
+        ASSERT_TRUE(queue.dequeue() == i);
+    }
+    ASSERT_TRUE(queue.capacity_ == 16 && queue.capacity_stats().shrinks == 2);
+
+    // the same round trips as the stack's test 11
+    CircularQueue eager(16, CapacityPolicy(2.0, 0.45));
+    CircularQueue calm(16, CapacityPolicy(2.0, 0.45, 64));
+    CircularQueue* queues[] = {&eager, &calm};
+    for (CircularQueue* q : queues) {
+        for (int i = 0; i < 17; i++) q->enqueue(i);
+        for (int round = 0; round < 100; round++) {
+            for (int i = 0; i < 4; i++) q->dequeue();
+            for (int i = 0; i < 4; i++) q->enqueue(i);
+        }
+        ASSERT_TRUE(q->size() == 17);
+    }
+    ASSERT_TRUE(eager.capacity_stats().reallocations() == 201);
+    ASSERT_TRUE(calm.capacity_stats().reallocations() < 20);
+
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef CAPACITY_POLICY_H
+#define CAPACITY_POLICY_H
+
+#include <cstddef>
+#include <stdexcept>
+
+// What a container's reallocations have cost so far.
+struct CapacityStats {
+    // Reallocations that grew the array, and ones that shrank it.
+    unsigned long long grows;
+    unsigned long long shrinks;
+
+    // Bytes of elements moved to a new array, over all reallocations.
+    unsigned long long bytes_copied;
+
+    unsigned long long reallocations() const { return grows + shrinks; }
+};
+
+
+// When an array-backed container (SequentialList, DynamicStack,
+// CircularQueue) grows and shrinks, plus counters of what that cost.
+//
+// A full container grows by growth_factor. After a removal, a container
+// whose size is below shrink_threshold of its capacity shrinks by
+// growth_factor, but only once cooldown removals have gone by since its last
+// reallocation, and never below its minimum capacity: the larger of
+// min_capacity and the container's own minimum. shrink_threshold has to be
+// below 1 / growth_factor, so that a shrunk array is never full: between the
+// two thresholds is the room that keeps a container going back and forth
+// across a boundary from reallocating every few operations.
+//
+// The default (2, 0.25, no cooldown) is the doubling and halving the
+// containers have always done.
+class CapacityPolicy {
+public:
+    explicit CapacityPolicy(double growth_factor = 2.0, double shrink_threshold = 0.25,
+                            unsigned int cooldown = 0, unsigned int min_capacity = 0)
+        : growth_factor_(growth_factor), shrink_threshold_(shrink_threshold),
+          cooldown_(cooldown), min_capacity_(min_capacity), removals_(0) {
+        if (!(growth_factor > 1.0))
+            throw std::invalid_argument("CapacityPolicy: growth factor must be above 1");
+        if (!(shrink_threshold >= 0.0 && shrink_threshold * growth_factor < 1.0))
+            throw std::invalid_argument("CapacityPolicy: shrink threshold must be below 1 / growth factor");
+        reset_stats();
+    }
+
+    double growth_factor() const { return growth_factor_; }
+    double shrink_threshold() const { return shrink_threshold_; }
+    unsigned int cooldown() const { return cooldown_; }
+    unsigned int min_capacity() const { return min_capacity_; }
+
+    // The larger of min_capacity and the container's own minimum.
+    unsigned int floor(unsigned int container_min) const {
+        return min_capacity_ > container_min ? min_capacity_ : container_min;
+    }
+
+    // The capacity to grow to from capacity so that needed elements fit:
+    // capacity times growth_factor, as many times as that takes.
+    unsigned int grow_to(unsigned int capacity, unsigned int needed) const {
+        unsigned long long cap = capacity;
+        while (cap < needed) {
+            unsigned long long next = (unsigned long long)(cap * growth_factor_);
+            cap = next > cap ? next : cap + 1;
+        }
+        return cap > 0xFFFFFFFFull ? needed : (unsigned int)cap;
+    }
+
+    // The capacity one shrink takes capacity down to.
+    unsigned int shrink_to(unsigned int capacity, unsigned int floor) const {
+        unsigned int cap = (unsigned int)(capacity / growth_factor_);
+        return cap < floor ? floor : cap;
+    }
+
+    // True if size is below the shrink threshold of capacity, and capacity
+    // is above floor.
+    bool sparse(unsigned int size, unsigned int capacity, unsigned int floor) const {
+        return capacity > floor && size < (unsigned int)(capacity * shrink_threshold_);
+    }
+
+    // Called after removing removed elements: true if the container should
+    // shrink now.
+    bool should_shrink(unsigned int size, unsigned int capacity, unsigned int floor,
+                       unsigned int removed = 1) {
+        removals_ += removed;
+        return removals_ >= cooldown_ && sparse(size, capacity, floor);
+    }
+
+    // Called on every reallocation, with how many bytes of elements it moved.
+    void record_resize(bool grew, std::size_t bytes_copied) {
+        if (grew) stats_.grows++;
+        else stats_.shrinks++;
+        stats_.bytes_copied += bytes_copied;
+        removals_ = 0;
+    }
+
+    const CapacityStats& stats() const { return stats_; }
+
+    void reset_stats() {
+        stats_.grows = 0;
+        stats_.shrinks = 0;
+        stats_.bytes_copied = 0;
+    }
+
+private:
+    double growth_factor_;
+    double shrink_threshold_;
+    unsigned int cooldown_;
+    unsigned int min_capacity_;
+
+    unsigned long long removals_;    // since the last reallocation
+    CapacityStats stats_;
+};
+
+#endif